@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# Compiles each section program that declares a `Frame_budget` with
+# `CPP_MACHINERY_CHECK_FRAME_BUDGETS` defined, runs it, and fails if any program fails to compile
+# or exits with a nonzero code, which it does when a coroutine frame exceeds its budget.
+#
+#   code/check-frame-budgets.sh             # With `g++ -O2`.
+#   CXX=clang++ code/check-frame-budgets.sh -O0
+#
+# Options, if any, replace the default `-O2`. The programs are run without arguments; those
+# that do a lot of work skip it under `CPP_MACHINERY_CHECK_FRAME_BUDGETS`, since the budgets are
+# measured during static initialization.
+
+set -u
+cd "$(dirname "$0")" || exit 1
+
+compiler="${CXX:-g++}"
+options=("$@")
+if [ ${#options[@]} -eq 0 ]; then options=(-O2); fi
+
+build_dir="$(mktemp -d)"
+trap 'rm -rf "$build_dir"' EXIT
+
+n_checked=0
+n_failed=0
+for source in sections/*/*.cpp; do
+    grep -q 'Frame_budget(' "$source" || continue
+    name="$(basename "$source" .cpp)"
+
+    n_checked=$((n_checked + 1))
+    log="$build_dir/$name.log"
+    if ! "$compiler" -std=c++20 "${options[@]}" -pthread -D CPP_MACHINERY_CHECK_FRAME_BUDGETS \
+            -I microlibs "$source" -o "$build_dir/$name" >"$log" 2>&1; then
+        echo "FAILED to compile: $source"
+        cat "$log"
+        n_failed=$((n_failed + 1))
+        continue
+    fi
+    if "$build_dir/$name" </dev/null >/dev/null 2>"$log"; then
+        echo "ok: $source"
+    else
+        echo "FAILED: $source"
+        cat "$log"
+        n_failed=$((n_failed + 1))
+    fi
+done
+
+echo "$n_failed of $n_checked programs failed."
+[ "$n_failed" -eq 0 ]
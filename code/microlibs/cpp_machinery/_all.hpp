@@ -2,3 +2,4 @@
 
 #include <cpp_machinery/basic.hpp>
 #include <cpp_machinery/coroutine.hpp>
+#include <cpp_machinery/threading.hpp>
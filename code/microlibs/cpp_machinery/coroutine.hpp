@@ -1,3 +1,13 @@
 ﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
 
+#include <cpp_machinery/coroutine/Async_sequence_.hpp>
+#include <cpp_machinery/coroutine/Checked_sequence_.hpp>
+#include <cpp_machinery/coroutine/Frame_arena.hpp>
+#include <cpp_machinery/coroutine/Frame_budget.hpp>
+#include <cpp_machinery/coroutine/Run_loop.hpp>
 #include <cpp_machinery/coroutine/Sequence_.hpp>
+#include <cpp_machinery/coroutine/Shared_replay_.hpp>
+#include <cpp_machinery/coroutine/Task_.hpp>
+#include <cpp_machinery/coroutine/Timer_wheel.hpp>
+#include <cpp_machinery/coroutine/batch_consumption.hpp>
+#include <cpp_machinery/coroutine/task_combinators.hpp>
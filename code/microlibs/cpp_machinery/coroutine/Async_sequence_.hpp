@@ -0,0 +1,152 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, ref_
+#include <cpp_machinery/coroutine/Frame_budget.hpp>  // Frame_size_tracking
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace cpp_machinery::coroutine {
+    using   std::convertible_to,                                                    // <concepts>
+            std::coroutine_handle, std::noop_coroutine, std::suspend_always,        // <coroutine>
+            std::current_exception, std::exception_ptr, std::rethrow_exception,     // <exception>
+            std::nullopt, std::optional,                                            // <optional>
+            std::exchange, std::forward, std::move;                                 // <utility>
+
+    template< class Yield_result > class Async_sequence_;
+
+    template< class Yield_result >
+    class Async_sequence_promise_:
+        public Frame_size_tracking
+    {
+        using Self      = Async_sequence_promise_;
+
+        optional<Yield_result>  m_value;
+        exception_ptr           m_x_ptr;
+        coroutine_handle<>      m_consumer;     // The coroutine awaiting the next value.
+
+        // Transfers control directly to the consumer, which then has a value or end-of-sequence.
+        struct Transfer_to_consumer
+        {
+            auto await_ready() const noexcept -> bool { return false; }
+
+            template< class Promise >       // `Self` or, for a frame in an arena, derived from it.
+            auto await_suspend( const coroutine_handle<Promise> h ) const noexcept
+                -> coroutine_handle<>
+            {
+                const coroutine_handle<> consumer = exchange( h.promise().m_consumer, nullptr );
+                return (consumer? consumer : noop_coroutine());
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+    public:
+        using Handle    = coroutine_handle<Self>;
+
+        auto get_return_object() -> Async_sequence_<Yield_result>
+        { return Async_sequence_<Yield_result>( Handle::from_promise( *this ) ); }
+
+        auto initial_suspend() const noexcept   -> suspend_always       { return {}; }
+        auto final_suspend() noexcept           -> Transfer_to_consumer { m_value.reset(); return {}; }
+
+        void unhandled_exception() { m_x_ptr = current_exception(); }
+
+        template< convertible_to<Yield_result> From >
+        auto yield_value( From&& from )
+            -> Transfer_to_consumer
+        {
+            m_value.emplace( forward<From>( from ) );
+            return {};
+        }
+
+        void return_void() {}
+
+        // `co_await` of any awaitable is allowed in the producer, e.g. i/o or a timer; the
+        // default behavior, without `await_transform`, is what's wanted.
+
+        void set_consumer( const coroutine_handle<> h ) { m_consumer = h; }
+
+        auto moved_value_or_nullopt()
+            -> optional<Yield_result>
+        {
+            if( m_x_ptr ) { rethrow_exception( exchange( m_x_ptr, nullptr ) ); }
+            optional<Yield_result> result = move( m_value );
+            m_value.reset();
+            return result;
+        }
+    };
+
+
+    // Async_sequence_.
+    // A sequence whose producer can `co_await` between its `co_yield`s, e.g. for i/o. It's
+    // consumed from another coroutine with `co_await seq.next()`, which produces an `optional`
+    // that's empty at the end of the sequence. Control is transferred symmetrically both ways,
+    // so no thread blocks while the producer waits: the consumer is just suspended until the
+    // producer, resumed by whatever it awaited, yields a value or finishes.
+    //
+    //  auto lines( ref_<Run_loop> loop ) -> Async_sequence_<string>
+    //  {
+    //      for( ;; ) {
+    //          optional<string> line = co_await async_read_line( loop );
+    //          if( not line ) { break; }
+    //          co_yield move( *line );
+    //      }
+    //  }
+    //
+    //  auto consumer( ref_<Run_loop> loop ) -> Task
+    //  {
+    //      auto seq = lines( loop );
+    //      while( const optional<string> line = co_await seq.next() ) { puts( line->c_str() ); }
+    //  }
+    //
+    template< class Yield_result >
+    class Async_sequence_
+    {
+    public:
+        using Promise   = Async_sequence_promise_< Yield_result >;
+        using Handle    = typename Promise::Handle;
+
+        using promise_type = Promise;       // Required.
+
+    private:
+        Async_sequence_( in_<Async_sequence_> ) = delete;
+        auto operator=( in_<Async_sequence_> ) = delete;
+
+        Handle      m_cor_handle;
+
+        struct Next_awaiter
+        {
+            Handle  m_producer;
+
+            auto await_ready() const noexcept -> bool { return m_producer.done(); }
+
+            auto await_suspend( const coroutine_handle<> consumer ) const noexcept
+                -> coroutine_handle<>
+            {
+                m_producer.promise().set_consumer( consumer );
+                return m_producer;
+            }
+
+            auto await_resume() const
+                -> optional<Yield_result>
+            { return m_producer.promise().moved_value_or_nullopt(); }
+        };
+
+    public:
+        ~Async_sequence_() { if( m_cor_handle ) { m_cor_handle.destroy(); } }
+        explicit Async_sequence_( const Handle h ): m_cor_handle( h ) {}
+
+        // A moved-from sequence can only be destroyed.
+        Async_sequence_( Async_sequence_&& other ) noexcept:
+            m_cor_handle( exchange( other.m_cor_handle, nullptr ) )
+        {}
+
+        auto is_finished() const -> bool { return m_cor_handle.done(); }
+
+        // Precondition: no other `next()` is pending.
+        auto next() const noexcept -> Next_awaiter { return Next_awaiter{ m_cor_handle }; }
+    };
+}  // namespace cpp_machinery::coroutine
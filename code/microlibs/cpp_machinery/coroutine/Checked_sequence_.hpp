@@ -0,0 +1,192 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, const_, ref_
+#include <cpp_machinery/coroutine/Frame_budget.hpp>  // Frame_size_tracking
+
+#include <assert.h>     // assert
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// An exception free alternative to `Sequence_`, usable with e.g. `-fno-exceptions`. Failure is
+// reported as an error value, `co_return error;`, à la `std::expected<T, E>`. A value
+// initialized `Error`, e.g. `std::errc()` or `0`, means “no error”, so a successful producer
+// ends with `co_return {};`. Note: just falling off the end of the coroutine body is UB, which
+// in a debug build is caught by an `assert` in `final_suspend`.
+//
+// Example producer and usage:
+//
+//  auto lines_of( const string_view text ) -> Checked_sequence_<string_view, errc>
+//  {
+//      for( const string_view line: split( text, '\n' ) ) {
+//          if( line.size() > max_line_length ) { co_return errc::value_too_large; }
+//          co_yield line;
+//      }
+//      co_return {};       // Required.
+//  }
+//
+//  auto lines = lines_of( text );
+//  for( const string_view line: lines ) { puts( line.data() ); }
+//  if( lines.has_error() ) { report( lines.error() ); }
+//
+// There are no runtime checks of usage: contract violations are caught only by `assert`.
+
+namespace cpp_machinery::coroutine {
+    using   std::convertible_to,                                                    // <concepts>
+            std::coroutine_handle, std::suspend_always,                             // <coroutine>
+            std::terminate,                                                         // <exception>
+            std::optional,                                                          // <optional>
+            std::exchange, std::forward;                                            // <utility>
+
+    template< class Yield_result, class Error >
+    class Checked_progress_state_
+    {
+    public:
+        struct State_index{ enum Enum{ startup, value, finished }; };
+
+    private:
+        State_index::Enum           m_state     = State_index::startup;
+        optional<Yield_result>      m_value;
+        Error                       m_error     = Error();
+
+    public:
+        auto state() const noexcept -> State_index::Enum { return m_state; }
+
+        auto is_in_startup_state() const noexcept   -> bool { return (m_state == State_index::startup); }
+        auto is_in_finished_state() const noexcept  -> bool { return (m_state == State_index::finished); }
+
+        template< convertible_to<Yield_result> From >
+        void set_value( From&& from ) noexcept
+        {
+            assert( not is_in_finished_state() );
+            m_value.emplace( forward<From>( from ) );
+            m_state = State_index::value;
+        }
+
+        void set_finished( const Error e ) noexcept
+        {
+            m_value.reset();
+            m_error = e;
+            m_state = State_index::finished;
+        }
+
+        // Precondition: in value state.
+        auto value() noexcept -> ref_<Yield_result> { assert( m_value ); return *m_value; }
+
+        auto has_error() const noexcept -> bool     { return (is_in_finished_state() and m_error != Error()); }
+        auto error() const noexcept -> Error        { return m_error; }
+    };
+
+
+    template< class Coroutine_result, class Yield_result, class Error >
+    class Checked_promise_:
+        public Checked_progress_state_< Yield_result, Error >,
+        public Frame_size_tracking
+    {
+        using Base      = Checked_progress_state_< Yield_result, Error >;
+        using Self      = Checked_promise_;
+
+    public:
+        using Handle    = coroutine_handle<Self>;
+
+        using   Base::set_finished, Base::set_value;
+
+        auto get_return_object() noexcept       // Can't be `const` b/c `from_promise`.
+            -> Coroutine_result
+        { return Coroutine_result( Handle::from_promise( *this ) ); }
+
+        auto initial_suspend() const noexcept   -> suspend_always   { return {}; }
+        auto final_suspend() const noexcept
+            -> suspend_always
+        {
+            assert( this->is_in_finished_state() );     // Else the producer lacks a `co_return`.
+            return {};
+        }
+
+        // Reached only if something throws in spite of the “no exceptions” contract.
+        void unhandled_exception() noexcept { terminate(); }
+
+        template< convertible_to<Yield_result> From >
+        auto yield_value( From&& from ) noexcept
+            -> suspend_always
+        {
+            set_value( forward<From>( from ) );
+            return {};
+        }
+
+        void return_value( const Error e ) noexcept { set_finished( e ); }
+    };
+
+
+    // Checked_sequence_.
+    // Offers `begin()` and `end()` like `Sequence_`, plus `has_error()` and `error()`.
+    //
+    template< class Yield_result, class Error >
+    class Checked_sequence_
+    {
+    public:
+        using Promise   = Checked_promise_< Checked_sequence_, Yield_result, Error >;
+        using Handle    = typename Promise::Handle;
+
+        using promise_type = Promise;       // Required.
+
+    private:
+        Checked_sequence_( in_<Checked_sequence_> ) = delete;
+        auto operator=( in_<Checked_sequence_> ) = delete;
+
+        Handle      m_cor_handle;
+
+        auto promise() const -> ref_<Promise> { return m_cor_handle.promise(); }
+
+    public:
+        ~Checked_sequence_() { if( m_cor_handle ) { m_cor_handle.destroy(); } }
+        Checked_sequence_( const Handle h ) noexcept: m_cor_handle( h ) {}
+
+        // A moved-from sequence can only be destroyed.
+        Checked_sequence_( Checked_sequence_&& other ) noexcept:
+            m_cor_handle( exchange( other.m_cor_handle, nullptr ) )
+        {}
+
+        auto is_finished() const noexcept -> bool { return m_cor_handle.done(); }
+
+        void start_if_not_started() noexcept
+        {
+            if( promise().is_in_startup_state() ) { m_cor_handle.resume(); }
+        }
+
+        // Preconditions: started and not finished.
+        void advance() noexcept { assert( not is_finished() );  m_cor_handle.resume(); }
+        auto value() noexcept -> ref_<Yield_result> { return promise().value(); }
+
+        // Meaningful when finished.
+        auto has_error() const noexcept -> bool { return promise().has_error(); }
+        auto error() const noexcept -> Error    { return promise().error(); }
+
+        class Iterator
+        {
+            Checked_sequence_*      m_p_sequence;
+
+        public:
+            Iterator( const_<Checked_sequence_*> p_sequence = nullptr ) noexcept: m_p_sequence( p_sequence ) {}
+
+            auto operator*() const noexcept -> Yield_result&    { return m_p_sequence->value(); }
+            auto operator++() noexcept      -> Iterator&        { m_p_sequence->advance(); return *this; }
+
+            auto is_at_end() const noexcept -> bool { return (m_p_sequence == nullptr or m_p_sequence->is_finished()); }
+
+            friend
+            auto operator==( in_<Iterator> a, in_<Iterator> b ) noexcept
+                -> bool
+            { return (a.m_p_sequence == b.m_p_sequence or (a.is_at_end() and b.is_at_end())); }
+
+            friend
+            auto operator!=( in_<Iterator> a, in_<Iterator> b ) noexcept -> bool { return not(a == b); }
+        };
+
+        // Starts the producer, so that the hot iteration path has no startup check.
+        auto begin() noexcept   -> Iterator { start_if_not_started(); return Iterator( this ); }
+        auto end() noexcept     -> Iterator { return Iterator(); }
+    };
+}  // namespace cpp_machinery::coroutine
@@ -0,0 +1,156 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // const_, in_, ref_
+#include <cpp_machinery/coroutine/Frame_budget.hpp>  // Frame_size_tracking, impl::record_frame_allocation
+
+#include <assert.h>     // assert
+#include <stddef.h>     // size_t
+#include <string.h>     // memcpy
+
+#include <coroutine>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace cpp_machinery::coroutine {
+    using   std::allocator_arg_t,                                                   // <memory>
+            std::vector;                                                            // <vector>
+
+    // Frame_arena.
+    // Bump allocation of the coroutine frames of e.g. a pipeline of sequences, so that they're
+    // next to each other in memory, and all released in one step. It's opt-in per coroutine, as
+    // with `std::generator`'s allocator form: a coroutine with one of this library's result
+    // types whose first parameters are `allocator_arg_t, Frame_arena&` has its frame in that
+    // arena. Other coroutines are unaffected, and pay nothing for this. Destroying a coroutine
+    // still runs the destructors of its locals, but doesn't free its frame; the arena's memory
+    // is reused after `reset()`, and freed by the arena's destructor. Not thread safe.
+    //
+    //  auto numbers( allocator_arg_t, ref_<Frame_arena>, const int n ) -> Sequence_<int>
+    //  { for( int i = 1; i <= n; ++i ) { co_yield i; } }
+    //
+    //  auto arena = Frame_arena();
+    //  for( const int v: numbers( allocator_arg, arena, 7 ) ) { ... }
+    //  arena.reset();
+    //
+    // Only free functions, and static member functions, are supported: for a non-static member
+    // function the object parameter comes first, and the frame is then allocated as usual.
+    //
+    class Frame_arena
+    {
+        Frame_arena( in_<Frame_arena> ) = delete;
+        auto operator=( in_<Frame_arena> ) = delete;
+
+        static constexpr size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+        struct Chunk{ char* p_start; size_t size; };
+
+        size_t              m_chunk_size;
+        vector<Chunk>       m_chunks;
+        int                 m_i_current     = -1;   // Index of the chunk being bump allocated from.
+        size_t              m_n_used        = 0;    // In the current chunk.
+        int                 m_n_live        = 0;    // Frames allocated and not yet deallocated.
+        size_t              m_n_allocated   = 0;    // Bytes, since construction or `reset`.
+
+        static auto aligned( const size_t size ) -> size_t { return (size + alignment - 1)/alignment*alignment; }
+
+        // Moves to the next chunk that can hold `size` bytes, adding one if necessary.
+        void go_to_chunk_for( const size_t size )
+        {
+            for( ++m_i_current; m_i_current < int( m_chunks.size() ); ++m_i_current ) {
+                if( m_chunks[m_i_current].size >= size ) { m_n_used = 0;  return; }
+            }
+            const size_t chunk_size = (size > m_chunk_size? aligned( size ) : m_chunk_size);
+            m_chunks.push_back( Chunk{ static_cast<char*>( ::operator new( chunk_size ) ), chunk_size } );
+            m_i_current = int( m_chunks.size() ) - 1;
+            m_n_used = 0;
+        }
+
+    public:
+        // Precondition: all frames in the arena have been destroyed.
+        ~Frame_arena()
+        {
+            assert( m_n_live == 0 );
+            for( const Chunk& chunk: m_chunks ) { ::operator delete( chunk.p_start, chunk.size ); }
+        }
+
+        explicit Frame_arena( const size_t chunk_size = 16*1024 ): m_chunk_size( aligned( chunk_size ) ) {}
+
+        auto n_live() const noexcept -> int             { return m_n_live; }
+        auto n_chunks() const noexcept -> int           { return int( m_chunks.size() ); }
+        auto n_allocated() const noexcept -> size_t     { return m_n_allocated; }
+
+        auto allocate( const size_t size )
+            -> void*
+        {
+            const size_t n_bytes = aligned( size );
+            if( m_i_current < 0 or m_n_used + n_bytes > m_chunks[m_i_current].size ) {
+                go_to_chunk_for( n_bytes );
+            }
+            const_<char*> p = m_chunks[m_i_current].p_start + m_n_used;
+            m_n_used += n_bytes;
+            m_n_allocated += n_bytes;
+            ++m_n_live;
+            return p;
+        }
+
+        // The memory is only reused after `reset`.
+        void deallocate( void* ) noexcept { --m_n_live; }
+
+        // Makes all the memory available for reuse, keeping the chunks.
+        // Precondition: all frames in the arena have been destroyed.
+        void reset() noexcept
+        {
+            assert( m_n_live == 0 );
+            m_i_current = (m_chunks.empty()? -1 : 0);
+            m_n_used = 0;
+            m_n_allocated = 0;
+        }
+    };
+
+    // Arena_frame_promise_.
+    // The promise type of a coroutine whose frame is in a `Frame_arena`, selected by the
+    // `std::coroutine_traits` specialization below. It adds only the allocation functions, so
+    // it has the layout of `Promise`, whose handles are also used for it. The arena is stored
+    // after the frame, so that `operator delete` knows where the frame came from.
+    //
+    template< class Promise >
+    class Arena_frame_promise_:
+        public Promise
+    {
+        static auto tag_offset( const size_t size ) -> size_t
+        {
+            return (size + alignof( Frame_arena* ) - 1)/alignof( Frame_arena* )*alignof( Frame_arena* );
+        }
+
+    public:
+        template< class... Args >
+        static auto operator new( const size_t size, allocator_arg_t, ref_<Frame_arena> arena, const Args&... )
+            -> void*
+        {
+            impl::record_frame_allocation( size );
+            const_<char*> p = static_cast<char*>( arena.allocate( tag_offset( size ) + sizeof( Frame_arena* ) ) );
+            const_<Frame_arena*> p_arena = &arena;
+            memcpy( p + tag_offset( size ), &p_arena, sizeof( p_arena ) );
+            return p;
+        }
+
+        static void operator delete( void* const p, const size_t size ) noexcept
+        {
+            Frame_arena* p_arena;
+            memcpy( &p_arena, static_cast<char*>( p ) + tag_offset( size ), sizeof( p_arena ) );
+            p_arena->deallocate( p );
+        }
+    };
+}  // namespace cpp_machinery::coroutine
+
+// For a coroutine `auto f( allocator_arg_t, Frame_arena&, ... ) -> R` where `R` is one of this
+// library's coroutine result types.
+template< class Result, class... Args >
+    requires std::is_base_of_v< cpp_machinery::coroutine::Frame_size_tracking, typename Result::promise_type >
+struct std::coroutine_traits< Result, std::allocator_arg_t, cpp_machinery::coroutine::Frame_arena&, Args... >
+{
+    using Promise = typename Result::promise_type;
+    using promise_type = cpp_machinery::coroutine::Arena_frame_promise_<Promise>;
+
+    static_assert( sizeof( promise_type ) == sizeof( Promise ) and alignof( promise_type ) == alignof( Promise ) );
+};
@@ -0,0 +1,135 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_
+
+#include <stddef.h>     // size_t
+#include <stdio.h>      // fflush, fprintf, stderr
+#include <stdlib.h>     // _Exit, EXIT_FAILURE
+
+#include <vector>
+
+// Coroutine frame size budgets. A budget is declared next to the coroutine, e.g.
+//
+//  auto numbers( const int n ) -> Sequence_<int> { ... }
+//  const auto numbers_budget = Frame_budget( "numbers", 64, []{ return numbers( 0 ); } );
+//
+// where the function creates an instance. Ordinarily that's all: nothing is measured. When
+// a program is compiled with `CPP_MACHINERY_CHECK_FRAME_BUDGETS` defined, the promise types
+// of this library record the size of each frame they allocate, each `Frame_budget` creates
+// an instance during static initialization and records its frame size, and at exit a report
+// is written to `stderr`. If any frame exceeds its budget the exit code is `EXIT_FAILURE`.
+//
+// The frame size includes all locals that live across a suspension point, e.g. a `std::stack`
+// or an array, plus the parameter copies and the promise. It's compiler and option specific,
+// so the budgets are for the compilers and options that matter, with some slack.
+
+namespace cpp_machinery::coroutine {
+    using   std::vector;                                                            // <vector>
+
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        namespace impl {
+            struct Frame_allocations
+            {
+                size_t  last_size   = 0;
+                int     n           = 0;
+            };
+
+            inline thread_local Frame_allocations frame_allocations = {};
+
+            inline void record_frame_allocation( const size_t size ) noexcept
+            {
+                frame_allocations.last_size = size;
+                ++frame_allocations.n;
+            }
+
+            class Frame_budget_report
+            {
+                Frame_budget_report( in_<Frame_budget_report> ) = delete;
+                auto operator=( in_<Frame_budget_report> ) = delete;
+
+                struct Entry{ const char* name; size_t budget; size_t size; bool is_allocated; };
+
+                vector<Entry>       m_entries;
+
+            public:
+                ~Frame_budget_report()
+                {
+                    int n_exceeded = 0;
+                    fprintf( stderr, "\nCoroutine frame sizes:\n" );
+                    for( const Entry& e: m_entries ) {
+                        const bool exceeded = (e.size > e.budget);
+                        n_exceeded += exceeded;
+                        if( e.is_allocated ) {
+                            fprintf( stderr, "  %-32s %6zu bytes, budget %6zu%s.\n",
+                                e.name, e.size, e.budget, (exceeded? ": EXCEEDED" : "")
+                                );
+                        } else {
+                            fprintf( stderr, "  %-32s (allocation elided), budget %6zu.\n", e.name, e.budget );
+                        }
+                    }
+                    fprintf( stderr, "%d of %d frame budgets exceeded.\n", n_exceeded, int( m_entries.size() ) );
+                    if( n_exceeded > 0 ) {
+                        fflush( nullptr );
+                        _Exit( EXIT_FAILURE );      // `exit` can't be called during exit.
+                    }
+                }
+
+                Frame_budget_report() {}
+
+                void add( const char* const name, const size_t budget, const size_t size, const bool is_allocated )
+                {
+                    m_entries.push_back( Entry{ name, budget, size, is_allocated } );
+                }
+            };
+
+            // Constructed before, and so destroyed after, the budgets of any translation unit
+            // that includes this header.
+            inline auto frame_budget_report = Frame_budget_report();
+        }  // namespace impl
+
+        // Base for promise types: sized frame allocation that records the size.
+        struct Frame_size_tracking
+        {
+            static auto operator new( const size_t size )
+                -> void*
+            {
+                impl::record_frame_allocation( size );
+                return ::operator new( size );
+            }
+
+            static void operator delete( void* const p, const size_t size ) noexcept
+            {
+                ::operator delete( p, size );
+            }
+        };
+
+        class Frame_budget
+        {
+        public:
+            template< class Create_func >
+            Frame_budget( const char* const name, const size_t budget, in_<Create_func> create )
+            {
+                const int n_before = impl::frame_allocations.n;
+                {
+                    const auto instance = create();
+                    (void) instance;
+                }
+                const bool is_allocated = (impl::frame_allocations.n != n_before);
+                const size_t size = (is_allocated? impl::frame_allocations.last_size : 0);
+                impl::frame_budget_report.add( name, budget, size, is_allocated );
+            }
+        };
+    #else
+        namespace impl {
+            inline void record_frame_allocation( size_t ) noexcept {}
+        }  // namespace impl
+
+        struct Frame_size_tracking {};
+
+        class Frame_budget
+        {
+        public:
+            template< class Create_func >
+            constexpr Frame_budget( const char*, size_t, in_<Create_func> ) noexcept {}
+        };
+    #endif
+}  // namespace cpp_machinery::coroutine
@@ -0,0 +1,288 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // const_, in_, ref_
+#include <cpp_machinery/coroutine/Task_.hpp>        // Task_
+#include <cpp_machinery/coroutine/Timer_wheel.hpp>  // impl::List_link, Timer_node, Timer_wheel
+
+#include <stdint.h>     // uint64_t
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace cpp_machinery::coroutine {
+    using   std::condition_variable,                                                // <condition_variable>
+            std::coroutine_handle,                                                  // <coroutine>
+            std::mutex, std::unique_lock,                                           // <mutex>
+            std::nullopt, std::optional,                                            // <optional>
+            std::is_same_v,                                                         // <type_traits>
+            std::move;                                                              // <utility>
+    namespace chrono = std::chrono;
+
+    // For `Run_loop::with_deadline`: an `optional` of the task's result, or for `void`, a `bool`.
+    template< class Result > struct Deadline_result_t_          { using T = optional<Result>; };
+    template<>               struct Deadline_result_t_<void>    { using T = bool; };
+    template< class Result > using Deadline_result_ = typename Deadline_result_t_<Result>::T;
+
+    // Run_loop.
+    // A FIFO queue of coroutines that are ready to be resumed, serviced by the thread that
+    // calls `run_until`. `post` can be called from any thread, e.g. from an i/o completion.
+    // Timers, i.e. `sleep_for` and `with_deadline`, can only be used in the loop's thread. They
+    // have 1 ms resolution, and the timer nodes are embedded in the awaiters. So are the queue
+    // nodes of `next_turn`, so that destroying a coroutine that's queued by it dequeues it.
+    // With nothing queued the loop's thread sleeps until the next timer is due, or a `post`.
+    //
+    //  auto loop = Run_loop();
+    //  auto task = consumer( loop );       // A `Task_` that uses `co_await loop.next_turn()`.
+    //  loop.run_until( [&]{ return task.is_done(); }, task.handle() );
+    //
+    class Run_loop
+    {
+        Run_loop( in_<Run_loop> ) = delete;
+        auto operator=( in_<Run_loop> ) = delete;
+
+        using Clock = chrono::steady_clock;
+        using Link = impl::List_link;
+        static constexpr auto tick_duration = chrono::milliseconds( 1 );
+
+        // A queued coroutine. A node from `post` is owned by the loop. Otherwise it's embedded
+        // in an awaiter, and destroying it dequeues it. A node can be linked from any thread,
+        // e.g. by `next_turn` in a coroutine that's running in a thread pool, always under
+        // `m_mutex`. An embedded node must be destroyed in the loop's thread.
+        class Queue_node:
+            private Link
+        {
+            friend class Run_loop;
+
+            Queue_node( in_<Queue_node> ) = delete;
+            auto operator=( in_<Queue_node> ) = delete;
+
+            Run_loop*               m_p_loop;
+            coroutine_handle<>      m_awaiting      = nullptr;
+            bool                    m_is_owned;
+
+        public:
+            ~Queue_node()
+            {
+                // `run_ready` unlinks the node, in the loop's thread, before resuming its
+                // coroutine, so usually `prev` is null and no lock is needed. Otherwise the node
+                // is still queued, and unlinking it changes the neighbors, so that locks.
+                if( not m_is_owned and prev ) {
+                    auto lock = unique_lock( m_p_loop->m_mutex );
+                    unlink();
+                }
+            }
+
+            Queue_node( const_<Run_loop*> p_loop, const bool is_owned = false ) noexcept:
+                m_p_loop( p_loop ), m_is_owned( is_owned )
+            {}
+        };
+
+        mutex                           m_mutex;
+        condition_variable              m_posted;
+        Link                            m_ready;            // List of `Queue_node`.
+        Timer_wheel                     m_timers;
+        const Clock::time_point         m_start_time    = Clock::now();
+
+        static auto node_of( const_<Link*> p ) -> ref_<Queue_node> { return *static_cast<Queue_node*>( p ); }
+
+        void enqueue( ref_<Queue_node> node, const coroutine_handle<> h )
+        {
+            node.m_awaiting = h;
+            {
+                auto lock = unique_lock( m_mutex );
+                node.link_before( m_ready );
+            }
+            m_posted.notify_one();
+        }
+
+        class Next_turn_awaiter:
+            public Queue_node
+        {
+        public:
+            using Queue_node::Queue_node;
+
+            auto await_ready() const noexcept -> bool { return false; }
+            void await_suspend( const coroutine_handle<> h ) { m_p_loop->enqueue( *this, h ); }
+            void await_resume() const noexcept {}
+        };
+
+        auto time_of_tick( const uint64_t tick ) const
+            -> Clock::time_point
+        { return m_start_time + tick*tick_duration; }
+
+        // Ticks that have fully passed.
+        auto n_ticks_elapsed() const
+            -> uint64_t
+        { return uint64_t( (Clock::now() - m_start_time)/tick_duration ); }
+
+        auto n_ticks_until( const Clock::time_point t ) const
+            -> uint64_t
+        {
+            // Rounded up so that a timer never fires early.
+            const uint64_t tick = uint64_t( chrono::ceil<chrono::milliseconds>( t - m_start_time )/tick_duration );
+            const uint64_t current = m_timers.current_tick();
+            return (tick > current? tick - current : 1);
+        }
+
+        class Sleep_awaiter:
+            public Timer_node
+        {
+            Run_loop*               m_p_loop;
+            Clock::time_point       m_wake_time;
+            coroutine_handle<>      m_awaiting;
+
+            static void on_expiry( ref_<Timer_node> node )
+            {
+                static_cast<Sleep_awaiter&>( node ).m_awaiting.resume();
+            }
+
+        public:
+            Sleep_awaiter( const_<Run_loop*> p_loop, const Clock::duration d ):
+                Timer_node( &on_expiry ), m_p_loop( p_loop ), m_wake_time( Clock::now() + d )
+            {}
+
+            auto await_ready() const noexcept -> bool { return (m_wake_time <= Clock::now()); }
+
+            void await_suspend( const coroutine_handle<> h )
+            {
+                m_awaiting = h;
+                m_p_loop->m_timers.insert( *this, m_p_loop->n_ticks_until( m_wake_time ) );
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        template< class Result >
+        class Deadline_awaiter:
+            public Timer_node
+        {
+            Run_loop*               m_p_loop;
+            Task_<Result>           m_task;
+            Clock::time_point       m_deadline;
+            coroutine_handle<>      m_awaiting;
+            bool                    m_timed_out     = false;
+
+            static void on_expiry( ref_<Timer_node> node )
+            {
+                auto& self = static_cast<Deadline_awaiter&>( node );
+                self.m_timed_out = true;
+                self.m_task.handle().promise().set_continuation( nullptr );
+                self.m_awaiting.resume();
+            }
+
+        public:
+            Deadline_awaiter( const_<Run_loop*> p_loop, Task_<Result>&& task, const Clock::duration d ):
+                Timer_node( &on_expiry ), m_p_loop( p_loop ), m_task( move( task ) ), m_deadline( Clock::now() + d )
+            {}
+
+            auto await_ready() const noexcept -> bool { return m_task.is_done(); }
+
+            auto await_suspend( const coroutine_handle<> h )
+                -> coroutine_handle<>
+            {
+                m_awaiting = h;
+                m_task.handle().promise().set_continuation( h );
+                m_p_loop->m_timers.insert( *this, m_p_loop->n_ticks_until( m_deadline ) );
+                return m_task.handle();
+            }
+
+            auto await_resume()
+                -> Deadline_result_<Result>
+            {
+                cancel();
+                if constexpr( is_same_v<Result, void> ) {
+                    if( not m_timed_out ) { m_task.result(); }
+                    return not m_timed_out;
+                } else {
+                    if( m_timed_out ) { return nullopt; }
+                    return m_task.result();
+                }
+            }
+        };
+
+    public:
+        ~Run_loop()
+        {
+            while( not m_ready.is_empty_list() ) {
+                ref_<Queue_node> node = node_of( m_ready.next );
+                node.unlink();
+                if( node.m_is_owned ) { delete &node; }
+            }
+        }
+
+        Run_loop() { m_ready.make_empty_list(); }
+
+        // Queues `h` for resumption. Unlike with `next_turn`, the coroutine must not be destroyed
+        // before it's resumed, e.g. by `with_deadline`.
+        void post( const coroutine_handle<> h ) { enqueue( *new Queue_node( this, true ), h ); }
+
+        // Suspends the awaiting coroutine and queues it for resumption after those already queued.
+        auto next_turn() noexcept -> Next_turn_awaiter { return Next_turn_awaiter( this ); }
+
+        // Suspends the awaiting coroutine for at least `d`.
+        auto sleep_for( const Clock::duration d ) -> Sleep_awaiter { return Sleep_awaiter( this, d ); }
+
+        // Runs `task` as if awaited, but for at most `d`. On timeout the task is destroyed, which
+        // cancels a pending `sleep_for` or `next_turn` in it, and the result is empty, or `false`
+        // for `void`. The task must not then be suspended on something that isn't cancelled by
+        // destruction, e.g. a coroutine handle passed to `post` or to another thread.
+        //
+        // Only a `Task_` is accepted, deliberately: cancellation is destruction of the task's
+        // frame. An arbitrary awaitable has no general way to be cancelled; to impose a deadline
+        // on one, await it in a `Task_` and make sure that it's cancelled by destruction.
+        template< class Result >
+        auto with_deadline( Task_<Result>&& task, const Clock::duration d )
+            -> Deadline_awaiter<Result>
+        { return Deadline_awaiter<Result>( this, move( task ), d ); }
+
+        auto n_pending_timers() const -> int { return m_timers.n_pending(); }
+
+        // Resumes the coroutines whose timers have expired, then the queued coroutines, without
+        // blocking. Returns the number resumed from the queue.
+        auto run_ready()
+            -> int
+        {
+            m_timers.advance_to( n_ticks_elapsed() );
+            Link batch;  batch.make_empty_list();
+            {
+                auto lock = unique_lock( m_mutex );
+                Link::splice_all( m_ready, batch );
+            }
+            // Resuming one coroutine can destroy another in the batch, which then unlinks itself.
+            // `batch` is only changed in this thread, so no locking.
+            int n = 0;
+            while( not batch.is_empty_list() ) {
+                ref_<Queue_node> node = node_of( batch.next );
+                const coroutine_handle<> h = node.m_awaiting;
+                node.unlink();
+                if( node.m_is_owned ) { delete &node; }
+                h.resume();
+                ++n;
+            }
+            return n;
+        }
+
+        // Services the queue until `is_done()`; blocks while the queue is empty. If `first` is
+        // specified it's resumed first, e.g. to start a top level task.
+        template< class Func >
+        void run_until( in_<Func> is_done, const coroutine_handle<> first = nullptr )
+        {
+            if( first ) { first.resume(); }
+            while( not is_done() ) {
+                if( run_ready() == 0 and not is_done() ) {
+                    auto lock = unique_lock( m_mutex );
+                    const auto is_posted = [this]{ return not m_ready.is_empty_list(); };
+                    if( m_timers.n_pending() > 0 ) {
+                        m_posted.wait_until( lock, time_of_tick( m_timers.next_due_tick() ), is_posted );
+                    } else {
+                        m_posted.wait( lock, is_posted );
+                    }
+                }
+            }
+        }
+    };
+}  // namespace cpp_machinery::coroutine
@@ -1,5 +1,6 @@
 ﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
-#include <cpp_machinery\basic\type_builders.hpp>    // in_, const_, ref_
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, const_, ref_
+#include <cpp_machinery/coroutine/Frame_budget.hpp>  // Frame_size_tracking
 
 #include <concepts>
 #include <coroutine>
@@ -15,7 +16,7 @@ namespace cpp_machinery::coroutine {
             std::current_exception, std::exception_ptr, std::rethrow_exception,     // <exception>
             std::optional,                                                          // <optional>
             std::runtime_error,                                                     // <stdexcept>
-            std::forward, std::move,                                                // <utility>
+            std::exchange, std::forward, std::move,                                 // <utility>
             std::get, std::variant, std::monostate;                                 // <variant>
 
     template< class Yield_result >
@@ -104,13 +105,15 @@ namespace cpp_machinery::coroutine {
     //
     template< class Coroutine_result, class Yield_result >
     class Simple_promise_:
-        public Simple_progress_state_< Yield_result >
+        public Simple_progress_state_< Yield_result >,
+        public Frame_size_tracking
     {
         using Base      = Simple_progress_state_< Yield_result >;
         using Self      = Simple_promise_;
-        using Handle    = coroutine_handle<Self>;
 
     public:
+        using Handle    = coroutine_handle<Self>;
+
         using   Base::set_finished, Base::set_exception, Base::set_value;
 
         auto get_return_object()      // Can't be `const` b/c `from_promise`.
@@ -147,7 +150,7 @@ namespace cpp_machinery::coroutine {
     {
     public:
         using Promise   = Simple_promise_< Coroutine_result, Yield_result >;
-        using Handle    = Promise::Handle;
+        using Handle    = typename Promise::Handle;
 
         using promise_type = Promise;       // Required.
 
@@ -172,14 +175,27 @@ namespace cpp_machinery::coroutine {
         }
 
      public:
-        ~Basic_sequence_() { m_cor_handle.destroy(); }
+        ~Basic_sequence_() { if( m_cor_handle ) { m_cor_handle.destroy(); } }
         Basic_sequence_( const Handle h ) : m_cor_handle( h ) {}
 
-        auto is_finished() const -> bool { return m_cor_handle.done(); }
+        // A moved-from sequence can only be destroyed.
+        Basic_sequence_( Basic_sequence_&& other ) noexcept:
+            m_cor_handle( exchange( other.m_cor_handle, nullptr ) )
+        {}
+
+        // Starts execution if necessary, so that an empty sequence is reported as finished.
+        // Rethrows an exception from the producer, so that a failure isn't taken as the end.
+        auto is_finished() const
+            -> bool
+        {
+            if_starting_up_start_execution();
+            promise().rethrow_if_exception();
+            return m_cor_handle.done();
+        }
 
         void advance()
         {
-            if( is_finished() ) {
+            if( m_cor_handle.done() ) {
                 throw runtime_error( "Finished, can't advance." );
             }
             m_cor_handle.resume();
@@ -215,6 +231,7 @@ namespace cpp_machinery::coroutine {
     public:
         using typename Base::Handle;
         Iterable_sequence_( const Handle h ): Base( h ) {}
+        Iterable_sequence_( Iterable_sequence_&& other ) noexcept: Base( move( other ) ) {}
 
         class Iterator
         {
@@ -0,0 +1,218 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, const_, ref_
+#include <cpp_machinery/coroutine/Sequence_.hpp>    // Sequence_
+
+#include <stddef.h>     // size_t
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cpp_machinery::coroutine {
+    using   std::erase, std::min,                                                   // <algorithm>
+            std::deque,                                                             // <deque>
+            std::current_exception, std::exception_ptr, std::rethrow_exception,     // <exception>
+            std::make_shared, std::shared_ptr,                                      // <memory>
+            std::optional,                                                          // <optional>
+            std::runtime_error,                                                     // <stdexcept>
+            std::move,                                                              // <utility>
+            std::vector;                                                            // <vector>
+
+    struct Replay_options
+    {
+        size_t  chunk_size              = 256;
+        bool    drop_passed_chunks      = false;    // I.e. bound memory by the slowest cursor.
+    };
+
+    // Shared_replay_.
+    // Memoizes a single-pass `Sequence_` so that any number of cursors can iterate over it.
+    // The producer is resumed only when some cursor runs past the values produced so far, and
+    // the values are kept in a chunked append-only buffer. With `drop_passed_chunks` the chunks
+    // that all live cursors have passed are dropped, and a new cursor then starts at the oldest
+    // value still kept. An exception from the producer is rethrown to each cursor that reaches
+    // the position where it occurred. Not thread safe.
+    //
+    // Example usage, where `primes` returns a `Sequence_<int>`:
+    //
+    //  auto replay = shared_replay( primes() );
+    //  auto a = replay.cursor();
+    //  auto b = replay.cursor();
+    //  for( const int v: a ) { if( v > 100 ) { break; } }   // Runs the producer.
+    //  for( const int v: b ) { if( v > 50 ) { break; } }    // Uses the cached values.
+    //
+    template< class Value >
+    class Shared_replay_
+    {
+    public:
+        class Cursor;
+
+    private:
+        struct State
+        {
+            optional<Sequence_<Value>>  source;
+            bool                        source_is_started   = false;
+            Replay_options              options;
+            deque<vector<Value>>        chunks;
+            size_t                      first_position      = 0;    // Of `chunks.front()[0]`.
+            size_t                      n_produced          = 0;
+            exception_ptr               x_ptr               = {};   // From the source.
+            vector<const Cursor*>       cursors;
+
+            State( Sequence_<Value>&& seq, in_<Replay_options> opt ):
+                source( move( seq ) ), options( opt )
+            {
+                if( options.chunk_size == 0 ) { options.chunk_size = 1; }
+            }
+
+            // Returns `false` if the source is exhausted, including by an exception.
+            auto produce_one_more()
+                -> bool
+            {
+                if( not source ) { return false; }
+                ref_<Sequence_<Value>> seq = *source;
+                if( source_is_started ) { seq.advance(); }
+                source_is_started = true;
+                bool is_finished;
+                try {
+                    is_finished = seq.is_finished();
+                } catch( ... ) {
+                    x_ptr = current_exception();
+                    is_finished = true;
+                }
+                if( is_finished ) {
+                    source.reset();         // Frees the coroutine frame.
+                    return false;
+                }
+                if( chunks.empty() or chunks.back().size() == options.chunk_size ) {
+                    chunks.emplace_back().reserve( options.chunk_size );
+                }
+                chunks.back().push_back( move( seq.value() ) );
+                ++n_produced;
+                return true;
+            }
+
+            auto is_available( const size_t position )
+                -> bool
+            {
+                while( position >= n_produced ) {
+                    if( not produce_one_more() ) {
+                        if( x_ptr ) { rethrow_exception( x_ptr ); }
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            auto item( const size_t position ) const
+                -> const Value&
+            {
+                const size_t offset = position - first_position;
+                return chunks[offset/options.chunk_size][offset%options.chunk_size];
+            }
+
+            void drop_passed_chunks()
+            {
+                if( not options.drop_passed_chunks ) { return; }
+                size_t min_position = n_produced;
+                for( const_<const Cursor*> p: cursors ) { min_position = min( min_position, p->m_position ); }
+                while( chunks.size() > 1 and min_position >= first_position + options.chunk_size ) {
+                    chunks.pop_front();
+                    first_position += options.chunk_size;
+                }
+            }
+        };
+
+        shared_ptr<State>   m_state;
+
+    public:
+        Shared_replay_( Sequence_<Value>&& seq, in_<Replay_options> options = {} ):
+            m_state( make_shared<State>( move( seq ), options ) )
+        {}
+
+        auto n_cached() const -> size_t { return m_state->n_produced - m_state->first_position; }
+
+        auto cursor() const -> Cursor { return Cursor( m_state ); }
+
+        class Cursor
+        {
+            friend struct State;
+
+            shared_ptr<State>   m_state;
+            size_t              m_position;
+
+            void register_self() { m_state->cursors.push_back( this ); }
+
+        public:
+            ~Cursor()
+            {
+                if( m_state ) {
+                    erase( m_state->cursors, this );
+                    m_state->drop_passed_chunks();
+                }
+            }
+
+            explicit Cursor( in_<shared_ptr<State>> state ):
+                m_state( state ), m_position( state->first_position )
+            { register_self(); }
+
+            Cursor( in_<Cursor> other ):
+                m_state( other.m_state ), m_position( other.m_position )
+            { register_self(); }
+
+            auto operator=( in_<Cursor> ) = delete;
+
+            auto position() const -> size_t { return m_position; }
+
+            auto is_at_end() const -> bool { return not m_state->is_available( m_position ); }
+
+            auto value() const
+                -> const Value&
+            {
+                if( not m_state->is_available( m_position ) ) {
+                    throw runtime_error( "Cursor at end, no value." );
+                }
+                return m_state->item( m_position );
+            }
+
+            void advance()
+            {
+                ++m_position;
+                if( m_position % m_state->options.chunk_size == 0 ) { m_state->drop_passed_chunks(); }
+            }
+
+            class Iterator
+            {
+                Cursor*     m_p_cursor;
+
+            public:
+                Iterator( const_<Cursor*> p_cursor = nullptr ): m_p_cursor( p_cursor ) {}
+
+                auto operator*() const  -> const Value&     { return m_p_cursor->value(); }
+                auto operator++()       -> Iterator&        { m_p_cursor->advance(); return *this; }
+
+                auto is_at_end() const  -> bool             { return (m_p_cursor == nullptr or m_p_cursor->is_at_end()); }
+
+                friend
+                auto operator==( in_<Iterator> a, in_<Iterator> b )
+                    -> bool
+                { return (a.m_p_cursor == b.m_p_cursor or (a.is_at_end() and b.is_at_end())); }
+
+                friend
+                auto operator!=( in_<Iterator> a, in_<Iterator> b ) -> bool { return not(a == b); }
+            };
+
+            auto begin()    -> Iterator { return Iterator( this ); }
+            auto end()      -> Iterator { return Iterator(); }
+        };
+    };
+
+    template< class Value >
+    auto shared_replay( Sequence_<Value>&& seq, in_<Replay_options> options = {} )
+        -> Shared_replay_<Value>
+    { return Shared_replay_<Value>( move( seq ), options ); }
+}  // namespace cpp_machinery::coroutine
@@ -0,0 +1,215 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // const_, in_, ref_
+#include <cpp_machinery/coroutine/Frame_budget.hpp>  // Frame_size_tracking
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+namespace cpp_machinery::coroutine {
+    using   std::atomic, std::memory_order_acq_rel,                                 // <atomic>
+            std::coroutine_handle, std::noop_coroutine, std::suspend_always,        // <coroutine>
+            std::current_exception, std::exception_ptr, std::rethrow_exception,     // <exception>
+            std::optional,                                                          // <optional>
+            std::runtime_error,                                                     // <stdexcept>
+            std::stop_source,                                                       // <stop_token>
+            std::exchange, std::forward, std::move;                                 // <utility>
+
+    template< class Result > class Task_;
+
+    // Completion_latch.
+    // Counts down the completions of a number of child tasks, plus one for the coroutine that
+    // awaits them all, which is resumed by whoever counts down last: possibly a child in
+    // another thread. Optionally records the first child to complete, and then requests stop.
+    //
+    class Completion_latch
+    {
+        Completion_latch( in_<Completion_latch> ) = delete;
+        auto operator=( in_<Completion_latch> ) = delete;
+
+        atomic<int>             m_count;
+        coroutine_handle<>      m_awaiting;
+        bool                    m_is_recording_first    = false;
+        atomic<const void*>     m_p_first               = nullptr;
+        stop_source*            m_p_stop_on_first       = nullptr;
+
+    public:
+        explicit Completion_latch( const int n_children ): m_count( n_children + 1 ) {}
+
+        void record_first_completion( stop_source* const p_stop = nullptr )
+        {
+            m_is_recording_first = true;
+            m_p_stop_on_first = p_stop;
+        }
+
+        // The first child to complete, identified by its promise address, if recording.
+        auto p_first() const noexcept -> const void* { return m_p_first.load(); }
+
+        // Before the children are started.
+        void set_awaiting( const coroutine_handle<> h ) noexcept { m_awaiting = h; }
+
+        // After the children are started. Returns whether the awaiting coroutine should suspend.
+        auto count_down_awaiting() noexcept
+            -> bool
+        { return (m_count.fetch_sub( 1, memory_order_acq_rel ) != 1); }
+
+        // Returns the coroutine to transfer control to.
+        auto count_down_child( const void* const p_child ) noexcept
+            -> coroutine_handle<>
+        {
+            if( m_is_recording_first ) {
+                const void* p_none = nullptr;
+                if( m_p_first.compare_exchange_strong( p_none, p_child ) and m_p_stop_on_first ) {
+                    m_p_stop_on_first->request_stop();
+                }
+            }
+            return (m_count.fetch_sub( 1, memory_order_acq_rel ) == 1? m_awaiting : noop_coroutine());
+        }
+    };
+
+    // Common part of the promise types: the awaiting coroutine or latch, if any, and exception.
+    class Task_promise_base:
+        public Frame_size_tracking
+    {
+        coroutine_handle<>      m_continuation;
+        Completion_latch*       m_p_latch       = nullptr;
+        exception_ptr           m_x_ptr;
+
+        // Transfers control to the awaiting coroutine, if any, else back to `resume()` caller.
+        struct Final_awaiter
+        {
+            auto await_ready() const noexcept -> bool { return false; }
+
+            template< class Promise >
+            auto await_suspend( const coroutine_handle<Promise> h ) const noexcept
+                -> coroutine_handle<>
+            {
+                ref_<Task_promise_base> self = h.promise();
+                if( self.m_p_latch ) { return self.m_p_latch->count_down_child( &self ); }
+                const coroutine_handle<> continuation = self.m_continuation;
+                return (continuation? continuation : noop_coroutine());
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+    public:
+        auto initial_suspend() const noexcept   -> suspend_always   { return {}; }
+        auto final_suspend() const noexcept     -> Final_awaiter    { return {}; }
+
+        void unhandled_exception() { m_x_ptr = current_exception(); }
+
+        void set_continuation( const coroutine_handle<> h ) { m_continuation = h; }
+        void set_latch( const_<Completion_latch*> p_latch ) { m_p_latch = p_latch; }
+
+        void rethrow_if_exception() const
+        {
+            if( m_x_ptr ) { rethrow_exception( m_x_ptr ); }
+        }
+    };
+
+    template< class Result >
+    class Task_promise_:
+        public Task_promise_base
+    {
+        optional<Result>    m_result;
+
+    public:
+        auto get_return_object() -> Task_<Result>;
+
+        template< class From >
+        void return_value( From&& from ) { m_result.emplace( forward<From>( from ) ); }
+
+        auto result() -> Result
+        {
+            rethrow_if_exception();
+            if( not m_result ) { throw runtime_error( "Task_ has no result." ); }
+            return move( *m_result );
+        }
+    };
+
+    template<>
+    class Task_promise_<void>:
+        public Task_promise_base
+    {
+    public:
+        auto get_return_object() -> Task_<void>;
+
+        void return_void() {}
+        void result() { rethrow_if_exception(); }
+    };
+
+
+    // Task_.
+    // A lazily started coroutine that produces a `Result`. Inside another coroutine a task is
+    // started and awaited with `co_await`, which transfers control symmetrically, i.e. without
+    // nesting calls. Top level code can instead call `start()`, e.g. via a `Run_loop`.
+    //
+    //  auto answer() -> Task_<int> { co_return 42; }
+    //  auto user() -> Task_<void> { const int v = co_await answer(); printf( "%d\n", v ); }
+    //
+    template< class Result >
+    class Task_
+    {
+    public:
+        using Promise   = Task_promise_< Result >;
+        using Handle    = coroutine_handle< Promise >;
+
+        using promise_type = Promise;       // Required.
+
+    private:
+        Task_( in_<Task_> ) = delete;
+        auto operator=( in_<Task_> ) = delete;
+
+        Handle      m_cor_handle;
+
+        struct Awaiter
+        {
+            Handle  m_task_handle;
+
+            auto await_ready() const noexcept -> bool { return m_task_handle.done(); }
+
+            auto await_suspend( const coroutine_handle<> awaiting ) const noexcept
+                -> coroutine_handle<>
+            {
+                m_task_handle.promise().set_continuation( awaiting );
+                return m_task_handle;
+            }
+
+            auto await_resume() const -> Result { return m_task_handle.promise().result(); }
+        };
+
+    public:
+        ~Task_() { if( m_cor_handle ) { m_cor_handle.destroy(); } }
+        explicit Task_( const Handle h ): m_cor_handle( h ) {}
+
+        // A moved-from task can only be destroyed.
+        Task_( Task_&& other ) noexcept: m_cor_handle( exchange( other.m_cor_handle, nullptr ) ) {}
+
+        auto handle() const -> Handle   { return m_cor_handle; }
+        auto is_done() const -> bool    { return m_cor_handle.done(); }
+
+        // For top level code. Runs the task until its first suspension that isn't a transfer.
+        void start() { m_cor_handle.resume(); }
+
+        // Precondition: `is_done()`.
+        auto result() -> Result { return m_cor_handle.promise().result(); }
+
+        auto operator co_await() const noexcept -> Awaiter { return Awaiter{ m_cor_handle }; }
+    };
+
+    template< class Result >
+    inline auto Task_promise_<Result>::get_return_object()
+        -> Task_<Result>
+    { return Task_<Result>( Task_<Result>::Handle::from_promise( *this ) ); }
+
+    inline auto Task_promise_<void>::get_return_object()
+        -> Task_<void>
+    { return Task_<void>( Task_<void>::Handle::from_promise( *this ) ); }
+
+    using Task = Task_<void>;
+}  // namespace cpp_machinery::coroutine
@@ -0,0 +1,233 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // const_, in_, ref_
+
+#include <stdint.h>     // uint64_t, UINT64_MAX
+
+namespace cpp_machinery::coroutine {
+    class Timer_wheel;
+
+    namespace impl {
+        // Circular doubly linked list links, also used by `Run_loop`. A list head is a link that's not
+        // in a node.
+        struct List_link
+        {
+            List_link*      prev    = nullptr;      // Null when not in a list.
+            List_link*      next    = nullptr;
+
+            void make_empty_list() noexcept { prev = next = this; }
+            auto is_empty_list() const noexcept -> bool { return (next == this); }
+
+            void link_before( ref_<List_link> other ) noexcept
+            {
+                prev = other.prev;  next = &other;
+                prev->next = this;  other.prev = this;
+            }
+
+            void unlink() noexcept
+            {
+                prev->next = next;  next->prev = prev;
+                prev = next = nullptr;
+            }
+
+            // Moves all nodes of list `from` to the empty list `to`.
+            static void splice_all( ref_<List_link> from, ref_<List_link> to ) noexcept
+            {
+                if( from.is_empty_list() ) { return; }
+                to.next = from.next;  to.prev = from.prev;
+                to.next->prev = &to;  to.prev->next = &to;
+                from.make_empty_list();
+            }
+        };
+    }  // namespace impl
+
+    // Timer_node.
+    // Intrusive list node for a `Timer_wheel`, meant to be embedded in e.g. an awaiter, so that
+    // there's no allocation per timer. Destroying a node that's in a wheel cancels its timer.
+    //
+    class Timer_node:
+        private impl::List_link
+    {
+        friend class Timer_wheel;
+
+        Timer_node( in_<Timer_node> ) = delete;
+        auto operator=( in_<Timer_node> ) = delete;
+
+        Timer_wheel*    m_p_wheel       = nullptr;
+        uint64_t        m_expiry_tick   = 0;
+        void          (*m_on_expiry)( ref_<Timer_node> ) = nullptr;
+
+    public:
+        ~Timer_node() { cancel(); }
+
+        // `on_expiry` is called with this node, by `Timer_wheel::advance_to`.
+        explicit Timer_node( void (*on_expiry)( ref_<Timer_node> ) = nullptr ) noexcept:
+            m_on_expiry( on_expiry )
+        {}
+
+        void set_on_expiry( void (*on_expiry)( ref_<Timer_node> ) ) noexcept { m_on_expiry = on_expiry; }
+
+        auto is_pending() const noexcept -> bool { return (prev != nullptr); }
+        auto expiry_tick() const noexcept -> uint64_t { return m_expiry_tick; }
+
+        inline void cancel() noexcept;      // O(1).
+    };
+
+
+    // Timer_wheel.
+    // Hierarchical timing wheel with 4 levels of 256 slots, i.e. 2^32 ticks range, plus an
+    // overflow list beyond that. Insertion and cancellation are O(1); `advance_to` is O(1) per
+    // tick plus O(1) per timer per level it cascades down. The time unit is an abstract “tick”.
+    // Not thread safe.
+    //
+    class Timer_wheel
+    {
+        friend class Timer_node;
+        using Link = impl::List_link;
+
+        Timer_wheel( in_<Timer_wheel> ) = delete;
+        auto operator=( in_<Timer_wheel> ) = delete;
+
+        static constexpr int        n_levels        = 4;
+        static constexpr int        bits_per_level  = 8;
+        static constexpr int        n_slots         = 1 << bits_per_level;
+        static constexpr uint64_t   slot_mask       = n_slots - 1;
+
+        Link            m_slots[n_levels][n_slots];         // List heads.
+        Link            m_overflow;
+        uint64_t        m_current_tick      = 0;
+        int             m_n_pending         = 0;
+
+        static auto node_of( const_<Link*> p ) -> ref_<Timer_node> { return *static_cast<Timer_node*>( p ); }
+
+        auto list_for( const uint64_t expiry_tick ) -> ref_<Link>
+        {
+            const uint64_t delta = expiry_tick - m_current_tick;
+            for( int level = 0; level < n_levels; ++level ) {
+                const int shift = level*bits_per_level;
+                if( delta < (uint64_t( 1 ) << (shift + bits_per_level)) ) {
+                    return m_slots[level][(expiry_tick >> shift) & slot_mask];
+                }
+            }
+            return m_overflow;
+        }
+
+        void place( ref_<Timer_node> node ) { node.link_before( list_for( node.m_expiry_tick ) ); }
+
+        // Re-places the nodes of `list` relative to the current tick, i.e. one or more levels down.
+        void replace_all_in( ref_<Link> list )
+        {
+            Link local;  local.make_empty_list();
+            Link::splice_all( list, local );
+            while( not local.is_empty_list() ) {
+                ref_<Timer_node> node = node_of( local.next );
+                node.unlink();
+                place( node );
+            }
+        }
+
+        void cascade( const int level )
+        {
+            if( level == n_levels ) {
+                replace_all_in( m_overflow );
+                return;
+            }
+            const int shift = level*bits_per_level;
+            const uint64_t index = (m_current_tick >> shift) & slot_mask;
+            if( index == 0 ) { cascade( level + 1 ); }
+            replace_all_in( m_slots[level][index] );
+        }
+
+        void fire_all_in( ref_<Link> list )
+        {
+            Link local;  local.make_empty_list();
+            Link::splice_all( list, local );
+            // A callback may destroy, and thereby cancel, other nodes in `local`.
+            while( not local.is_empty_list() ) {
+                ref_<Timer_node> node = node_of( local.next );
+                node.cancel();
+                node.m_on_expiry( node );
+            }
+        }
+
+        static void clear( ref_<Link> list )
+        {
+            while( not list.is_empty_list() ) { node_of( list.next ).unlink(); }
+        }
+
+    public:
+        ~Timer_wheel()
+        {
+            // Leaves any pending nodes unlinked, so their destructors are no-ops.
+            for( auto& level: m_slots ) { for( Link& list: level ) { clear( list ); } }
+            clear( m_overflow );
+        }
+
+        Timer_wheel()
+        {
+            for( auto& level: m_slots ) { for( Link& list: level ) { list.make_empty_list(); } }
+            m_overflow.make_empty_list();
+        }
+
+        auto current_tick() const noexcept -> uint64_t  { return m_current_tick; }
+        auto n_pending() const noexcept -> int          { return m_n_pending; }
+
+        // The first tick where `advance_to` can fire a timer, or `UINT64_MAX` if none is pending.
+        // That's exact for a timer due within 256 ticks. Otherwise it can be the earlier tick
+        // where a later timer cascades down a level, after which this should be asked again.
+        // O(slots) in the worst case, i.e. meant for deciding how long to wait, not per tick.
+        auto next_due_tick() const noexcept
+            -> uint64_t
+        {
+            if( m_n_pending == 0 ) { return UINT64_MAX; }
+            uint64_t result = UINT64_MAX;
+            for( int level = 0; level < n_levels; ++level ) {
+                // The slot at offset `i` is fired, or cascaded, at tick `(base + i) << shift`.
+                // Offset 0 is the current slot, which at a level above 0 can hold timers due
+                // after a full turn of the level.
+                const int shift = level*bits_per_level;
+                const uint64_t base = m_current_tick >> shift;
+                for( uint64_t i = 1; i <= uint64_t( n_slots ); ++i ) {
+                    const uint64_t tick = (base + i) << shift;
+                    if( tick >= result ) { break; }
+                    if( not m_slots[level][(base + i) & slot_mask].is_empty_list() ) {
+                        result = tick;
+                        break;
+                    }
+                }
+            }
+            if( not m_overflow.is_empty_list() ) {
+                const int shift = n_levels*bits_per_level;
+                const uint64_t tick = ((m_current_tick >> shift) + 1) << shift;
+                if( tick < result ) { result = tick; }
+            }
+            return result;
+        }
+
+        // Precondition: `not node.is_pending()`. At least 1 tick is used.
+        void insert( ref_<Timer_node> node, const uint64_t n_ticks )
+        {
+            node.m_p_wheel = this;
+            node.m_expiry_tick = m_current_tick + (n_ticks > 0? n_ticks : 1);
+            place( node );
+            ++m_n_pending;
+        }
+
+        // Fires the timers that expire up to and including `tick`.
+        void advance_to( const uint64_t tick )
+        {
+            while( m_current_tick < tick ) {
+                ++m_current_tick;
+                if( (m_current_tick & slot_mask) == 0 ) { cascade( 1 ); }
+                fire_all_in( m_slots[0][m_current_tick & slot_mask] );
+            }
+        }
+    };
+
+    inline void Timer_node::cancel() noexcept
+    {
+        if( is_pending() ) {
+            unlink();
+            --m_p_wheel->m_n_pending;
+        }
+    }
+}  // namespace cpp_machinery::coroutine
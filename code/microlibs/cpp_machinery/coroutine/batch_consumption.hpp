@@ -0,0 +1,185 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // const_, in_, ref_
+#include <cpp_machinery/coroutine/Sequence_.hpp>    // Sequence_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // int64_t
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <utility>
+
+#ifdef __AVX2__
+#   include <immintrin.h>
+#endif
+
+// Bulk consumption of a `Sequence_`. Values are pulled one by one from the coroutine into a
+// local aligned buffer, and the consumer is handed contiguous spans, which it can process with
+// vectorized code. The kernels below use AVX2 when the compiler targets it (e.g. `-mavx2`),
+// and otherwise plain loops that the compiler is free to auto-vectorize.
+
+namespace cpp_machinery::coroutine::seq {
+    using   std::min, std::max,                             // <algorithm>
+            std::numeric_limits,                            // <limits>
+            std::span,                                      // <span>
+            std::move;                                      // <utility>
+
+    constexpr size_t default_batch_size = 64;
+
+    // Calls `f( span<const Value> )` for successive batches of at most `batch_size` values.
+    // `Value` must be default constructible.
+    template< size_t batch_size = default_batch_size, class Value, class Func >
+    void for_each_batch( ref_<Sequence_<Value>> sequence, Func&& f )
+    {
+        alignas( 64 ) Value buffer[batch_size];
+        size_t n = 0;
+        for( Value& v: sequence ) {
+            buffer[n] = move( v );
+            ++n;
+            if( n == batch_size ) {
+                f( span<const Value>( buffer, n ) );
+                n = 0;
+            }
+        }
+        if( n > 0 ) { f( span<const Value>( buffer, n ) ); }
+    }
+
+    template< size_t batch_size = default_batch_size, class Value, class Func >
+    void for_each_batch( Sequence_<Value>&& sequence, Func&& f )
+    {
+        for_each_batch<batch_size>( sequence, f );
+    }
+
+    namespace kernel {
+        inline auto sum( const span<const int> values )
+            -> int64_t
+        {
+            const int*          p       = values.data();
+            const_<const int*>  beyond  = p + values.size();
+            int64_t result = 0;
+            #ifdef __AVX2__
+                __m256i acc_lo = _mm256_setzero_si256();
+                __m256i acc_hi = _mm256_setzero_si256();
+                for( ; beyond - p >= 8; p += 8 ) {
+                    const __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) );
+                    acc_lo = _mm256_add_epi64( acc_lo, _mm256_cvtepi32_epi64( _mm256_castsi256_si128( v ) ) );
+                    acc_hi = _mm256_add_epi64( acc_hi, _mm256_cvtepi32_epi64( _mm256_extracti128_si256( v, 1 ) ) );
+                }
+                alignas( 32 ) int64_t lanes[4];
+                _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), _mm256_add_epi64( acc_lo, acc_hi ) );
+                result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            #endif
+            for( ; p != beyond; ++p ) { result += *p; }
+            return result;
+        }
+
+        inline auto min_of( const span<const int> values )
+            -> int
+        {
+            const int*          p       = values.data();
+            const_<const int*>  beyond  = p + values.size();
+            int result = numeric_limits<int>::max();
+            #ifdef __AVX2__
+                __m256i acc = _mm256_set1_epi32( result );
+                for( ; beyond - p >= 8; p += 8 ) {
+                    acc = _mm256_min_epi32( acc, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ) );
+                }
+                alignas( 32 ) int lanes[8];
+                _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), acc );
+                for( const int v: lanes ) { result = min( result, v ); }
+            #endif
+            for( ; p != beyond; ++p ) { result = min( result, *p ); }
+            return result;
+        }
+
+        inline auto max_of( const span<const int> values )
+            -> int
+        {
+            const int*          p       = values.data();
+            const_<const int*>  beyond  = p + values.size();
+            int result = numeric_limits<int>::min();
+            #ifdef __AVX2__
+                __m256i acc = _mm256_set1_epi32( result );
+                for( ; beyond - p >= 8; p += 8 ) {
+                    acc = _mm256_max_epi32( acc, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ) );
+                }
+                alignas( 32 ) int lanes[8];
+                _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), acc );
+                for( const int v: lanes ) { result = max( result, v ); }
+            #endif
+            for( ; p != beyond; ++p ) { result = max( result, *p ); }
+            return result;
+        }
+
+        // Branch free so that it's auto-vectorizable for simple predicates.
+        template< class Value, class Pred >
+        auto count_if( const span<const Value> values, in_<Pred> pred )
+            -> size_t
+        {
+            size_t result = 0;
+            for( const Value& v: values ) { result += size_t( !!pred( v ) ); }
+            return result;
+        }
+    }  // namespace kernel
+
+    // Left fold of the batches: `op( accumulated, v )` for each value `v`, in order.
+    template< size_t batch_size = default_batch_size, class Value, class Result, class Op >
+    auto reduce( ref_<Sequence_<Value>> sequence, Result init, in_<Op> op )
+        -> Result
+    {
+        for_each_batch<batch_size>( sequence, [&]( const span<const Value> batch ) {
+            for( const Value& v: batch ) { init = op( move( init ), v ); }
+        } );
+        return init;
+    }
+
+    template< size_t batch_size = default_batch_size, class Value, class Result, class Op >
+    auto reduce( Sequence_<Value>&& sequence, Result init, in_<Op> op )
+        -> Result
+    { return reduce<batch_size>( sequence, move( init ), op ); }
+
+    inline auto sum( ref_<Sequence_<int>> sequence )
+        -> int64_t
+    {
+        int64_t result = 0;
+        for_each_batch( sequence, [&]( const span<const int> batch ) { result += kernel::sum( batch ); } );
+        return result;
+    }
+
+    inline auto sum( Sequence_<int>&& sequence ) -> int64_t { return sum( sequence ); }
+
+    // For an empty sequence the result is `numeric_limits<int>::max()`.
+    inline auto min_of( ref_<Sequence_<int>> sequence )
+        -> int
+    {
+        int result = numeric_limits<int>::max();
+        for_each_batch( sequence, [&]( const span<const int> batch ) { result = min( result, kernel::min_of( batch ) ); } );
+        return result;
+    }
+
+    inline auto min_of( Sequence_<int>&& sequence ) -> int { return min_of( sequence ); }
+
+    // For an empty sequence the result is `numeric_limits<int>::min()`.
+    inline auto max_of( ref_<Sequence_<int>> sequence )
+        -> int
+    {
+        int result = numeric_limits<int>::min();
+        for_each_batch( sequence, [&]( const span<const int> batch ) { result = max( result, kernel::max_of( batch ) ); } );
+        return result;
+    }
+
+    inline auto max_of( Sequence_<int>&& sequence ) -> int { return max_of( sequence ); }
+
+    template< class Value, class Pred >
+    auto count_if( ref_<Sequence_<Value>> sequence, in_<Pred> pred )
+        -> size_t
+    {
+        size_t result = 0;
+        for_each_batch( sequence, [&]( const span<const Value> batch ) { result += kernel::count_if( batch, pred ); } );
+        return result;
+    }
+
+    template< class Value, class Pred >
+    auto count_if( Sequence_<Value>&& sequence, in_<Pred> pred ) -> size_t { return count_if( sequence, pred ); }
+}  // namespace cpp_machinery::coroutine::seq
@@ -0,0 +1,198 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, ref_
+#include <cpp_machinery/coroutine/Task_.hpp>        // Completion_latch, Task_
+
+#include <assert.h>     // assert
+
+#include <coroutine>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Structured concurrency: `co_await when_all( tasks )` and `co_await when_any( stop, tasks )`.
+//
+// The child tasks are started in the awaiting coroutine's thread, and each child resumes the
+// awaiting coroutine via a `Completion_latch` when it's the last to complete. So the children
+// can also complete in other threads, e.g. after awaiting something that resumes them in a
+// thread pool; the awaiting coroutine is then resumed in the thread of the last child.
+//
+// The awaiting coroutine is resumed only when all children have completed, also for
+// `when_any`, so a child never outlives the `co_await`. Cancellation of the losers in
+// `when_any` is cooperative: the first child to complete requests stop on a `stop_source`
+// whose tokens the children are expected to check.
+
+namespace cpp_machinery::coroutine {
+    using   std::coroutine_handle,                                                  // <coroutine>
+            std::stop_source,                                                       // <stop_token>
+            std::apply, std::tuple,                                                 // <tuple>
+            std::is_same_v, std::is_void_v,                                         // <type_traits>
+            std::move,                                                              // <utility>
+            std::monostate,                                                         // <variant>
+            std::vector;                                                            // <vector>
+
+    // A `void` result is represented as `monostate` in tuples.
+    template< class Result > struct Result_value_t_         { using T = Result; };
+    template<>               struct Result_value_t_<void>   { using T = monostate; };
+    template< class Result > using Result_value_ = typename Result_value_t_<Result>::T;
+
+    template< class Result >
+    auto result_value_of( ref_<Task_<Result>> task )
+        -> Result_value_<Result>
+    {
+        if constexpr( is_void_v<Result> ) {
+            task.result();  return {};
+        } else {
+            return task.result();
+        }
+    }
+
+    namespace impl {
+        template< class Result >
+        void start_under( ref_<Completion_latch> latch, ref_<Task_<Result>> task )
+        {
+            task.handle().promise().set_latch( &latch );
+            task.start();
+        }
+    }  // namespace impl
+
+    // Precondition for all: the tasks are not started.
+
+    template< class Result >
+    class When_all_awaiter_
+    {
+        vector<Task_<Result>>   m_tasks;
+        Completion_latch        m_latch;
+
+    public:
+        explicit When_all_awaiter_( vector<Task_<Result>>&& tasks ):
+            m_tasks( move( tasks ) ), m_latch( int( m_tasks.size() ) )
+        {}
+
+        auto await_ready() const noexcept -> bool { return m_tasks.empty(); }
+
+        auto await_suspend( const coroutine_handle<> h )
+            -> bool
+        {
+            m_latch.set_awaiting( h );
+            for( Task_<Result>& task: m_tasks ) { impl::start_under( m_latch, task ); }
+            return m_latch.count_down_awaiting();
+        }
+
+        // Rethrows the first exception, in task order.
+        auto await_resume()
+        {
+            if constexpr( is_void_v<Result> ) {
+                for( Task_<Result>& task: m_tasks ) { task.result(); }
+            } else {
+                vector<Result> results;
+                results.reserve( m_tasks.size() );
+                for( Task_<Result>& task: m_tasks ) { results.push_back( task.result() ); }
+                return results;
+            }
+        }
+    };
+
+    template< class... Results >
+    class When_all_tuple_awaiter_
+    {
+        tuple<Task_<Results>...>    m_tasks;
+        Completion_latch            m_latch;
+
+    public:
+        explicit When_all_tuple_awaiter_( Task_<Results>&&... tasks ):
+            m_tasks( move( tasks )... ), m_latch( int( sizeof...( Results ) ) )
+        {}
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        auto await_suspend( const coroutine_handle<> h )
+            -> bool
+        {
+            m_latch.set_awaiting( h );
+            apply( [this]( auto&... task ) { (impl::start_under( m_latch, task ), ...); }, m_tasks );
+            return m_latch.count_down_awaiting();
+        }
+
+        auto await_resume()
+            -> tuple<Result_value_<Results>...>
+        {
+            return apply( []( auto&... task ) {
+                return tuple<Result_value_<Results>...>( result_value_of( task )... );
+            }, m_tasks );
+        }
+    };
+
+    // The winner's index and result, or just the index for `void` tasks.
+    template< class Result > struct Any_result_         { int index; Result value; };
+    template<>               struct Any_result_<void>   { int index; };
+
+    template< class Result >
+    class When_any_awaiter_
+    {
+        vector<Task_<Result>>   m_tasks;
+        Completion_latch        m_latch;
+
+    public:
+        When_any_awaiter_( ref_<stop_source> stop, vector<Task_<Result>>&& tasks ):
+            m_tasks( move( tasks ) ), m_latch( int( m_tasks.size() ) )
+        {
+            assert( not m_tasks.empty() );      // Else there's no first to complete.
+            m_latch.record_first_completion( &stop );
+        }
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        auto await_suspend( const coroutine_handle<> h )
+            -> bool
+        {
+            m_latch.set_awaiting( h );
+            for( Task_<Result>& task: m_tasks ) { impl::start_under( m_latch, task ); }
+            return m_latch.count_down_awaiting();
+        }
+
+        // Rethrows the winner's exception, if any. The losers' results are discarded.
+        auto await_resume()
+            -> Any_result_<Result>
+        {
+            int i = 0;
+            while( &m_tasks[i].handle().promise() != m_latch.p_first() ) { ++i; }
+            if constexpr( is_void_v<Result> ) {
+                m_tasks[i].result();
+                return { i };
+            } else {
+                return { i, m_tasks[i].result() };
+            }
+        }
+    };
+
+    template< class Result >
+    auto when_all( vector<Task_<Result>>&& tasks )
+        -> When_all_awaiter_<Result>
+    { return When_all_awaiter_<Result>( move( tasks ) ); }
+
+    template< class... Results >
+    auto when_all( Task_<Results>&&... tasks )
+        -> When_all_tuple_awaiter_<Results...>
+    { return When_all_tuple_awaiter_<Results...>( move( tasks )... ); }
+
+    template< class Result >
+    auto when_any( ref_<stop_source> stop, vector<Task_<Result>>&& tasks )
+        -> When_any_awaiter_<Result>
+    { return When_any_awaiter_<Result>( stop, move( tasks ) ); }
+
+    // All tasks have the same result type, as with a `vector`.
+    template< class Result, class... More_results >
+        requires (is_same_v<More_results, Result> and ...)
+    auto when_any( ref_<stop_source> stop, Task_<Result>&& first, Task_<More_results>&&... more )
+        -> When_any_awaiter_<Result>
+    {
+        vector<Task_<Result>> tasks;
+        tasks.reserve( 1 + sizeof...( More_results ) );
+        tasks.push_back( move( first ) );
+        (tasks.push_back( move( more ) ), ...);
+        return When_any_awaiter_<Result>( stop, move( tasks ) );
+    }
+}  // namespace cpp_machinery::coroutine
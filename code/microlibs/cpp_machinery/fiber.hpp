@@ -0,0 +1,6 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+
+// Stackful fibers, for POSIX systems. Not included by `_all.hpp`.
+#include <cpp_machinery/fiber/Fiber_sequence_.hpp>
+#include <cpp_machinery/fiber/Stack_pool.hpp>
+#include <cpp_machinery/fiber/context_switch.hpp>
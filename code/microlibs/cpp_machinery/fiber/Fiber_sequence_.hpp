@@ -0,0 +1,260 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // const_, in_, ref_
+#include <cpp_machinery/fiber/Stack_pool.hpp>       // Stack, Stack_pool
+#include <cpp_machinery/fiber/context_switch.hpp>   // Context, init_context, switch_context
+
+#include <stdint.h>     // uintptr_t
+
+#include <concepts>
+#include <exception>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cpp_machinery::fiber {
+    using   std::convertible_to, std::invocable,                                    // <concepts>
+            std::current_exception, std::exception_ptr, std::rethrow_exception,     // <exception>
+            std::optional,                                                          // <optional>
+            std::runtime_error,                                                     // <stdexcept>
+            std::decay_t,                                                           // <type_traits>
+            std::exchange, std::forward, std::move;                                 // <utility>
+
+    template< class Yield_result > class Fiber_yield_;
+
+    namespace impl {
+        // Thrown by a yield in a fiber whose sequence is destroyed before it's finished.
+        struct Fiber_cancellation {};
+
+        // Placed at the top of the fiber's own stack, so a fiber needs no other allocation.
+        template< class Yield_result >
+        class Fiber_control_
+        {
+            Fiber_control_( in_<Fiber_control_> ) = delete;
+            auto operator=( in_<Fiber_control_> ) = delete;
+
+            Stack_pool*             m_p_pool;
+            Stack                   m_stack;
+            Context                 m_consumer;
+            Context                 m_producer;
+            optional<Yield_result>  m_value;
+            exception_ptr           m_x_ptr;
+            bool                    m_is_started        = false;
+            bool                    m_is_finished       = false;
+            bool                    m_is_cancelling     = false;
+
+            virtual void produce() = 0;
+
+            static void run( void* const p_self )
+            {
+                ref_<Fiber_control_> self = *static_cast<Fiber_control_*>( p_self );
+                try {
+                    self.produce();
+                } catch( in_<Fiber_cancellation> ) {
+                    // Just finish.
+                } catch( ... ) {
+                    self.m_x_ptr = current_exception();
+                }
+                self.m_value.reset();
+                self.m_is_finished = true;
+                switch_context( self.m_producer, self.m_consumer );     // Never resumed.
+            }
+
+        protected:
+            virtual ~Fiber_control_() {}
+
+            Fiber_control_( ref_<Stack_pool> pool, in_<Stack> stack ):
+                m_p_pool( &pool ), m_stack( stack )
+            {}
+
+            // Precondition: `this` is at the top of `m_stack`.
+            void init_producer_context()
+            {
+                init_context( m_producer, Stack{ m_stack.p_start, reinterpret_cast<char*>( this ) }, &run, this );
+            }
+
+        public:
+            // Destroys an instance of a derived class, and releases the stack.
+            static void destroy( const_<Fiber_control_*> p )
+            {
+                if( p->m_is_started and not p->m_is_finished ) {
+                    p->m_is_cancelling = true;
+                    switch_context( p->m_consumer, p->m_producer );
+                }
+                const_<Stack_pool*> p_pool = p->m_p_pool;
+                const Stack stack = p->m_stack;
+                p->~Fiber_control_();
+                p_pool->release( stack );
+            }
+
+            auto is_started() const noexcept -> bool    { return m_is_started; }
+            auto is_finished() const noexcept -> bool   { return m_is_finished; }
+
+            // Runs the producer until its next yield or its end. An exception from the producer
+            // is rethrown here, once.
+            void resume()
+            {
+                m_is_started = true;
+                switch_context( m_consumer, m_producer );
+                if( m_x_ptr ) { rethrow_exception( exchange( m_x_ptr, nullptr ) ); }
+            }
+
+            template< class From >
+            void yield( From&& from )
+            {
+                m_value.emplace( forward<From>( from ) );
+                switch_context( m_producer, m_consumer );
+                if( m_is_cancelling ) { throw Fiber_cancellation(); }
+            }
+
+            auto value() -> ref_<Yield_result>
+            {
+                if( not m_value ) { throw runtime_error( "No value." ); }
+                return *m_value;
+            }
+        };
+
+        template< class Yield_result, class Func >
+        class Fiber_control_with_:
+            public Fiber_control_< Yield_result >
+        {
+            using Base = Fiber_control_< Yield_result >;
+
+            Func    m_produce;
+
+            void produce() override { m_produce( Fiber_yield_<Yield_result>( *this ) ); }
+
+        public:
+            template< class Init >
+            Fiber_control_with_( Init&& produce, ref_<Stack_pool> pool, in_<Stack> stack ):
+                Base( pool, stack ), m_produce( forward<Init>( produce ) )
+            { Base::init_producer_context(); }
+        };
+    }  // namespace impl
+
+
+    // Fiber_yield_.
+    // Passed to the producer function of a `Fiber_sequence_`; calling it yields a value. It can
+    // be called at any call depth in the fiber, e.g. from a recursive function.
+    //
+    template< class Yield_result >
+    class Fiber_yield_
+    {
+        impl::Fiber_control_<Yield_result>*     m_p_control;
+
+    public:
+        explicit Fiber_yield_( ref_<impl::Fiber_control_<Yield_result>> control ): m_p_control( &control ) {}
+
+        template< convertible_to<Yield_result> From >
+        void operator()( From&& from ) const { m_p_control->yield( forward<From>( from ) ); }
+    };
+
+
+    // Fiber_sequence_.
+    // A generator that runs its producer function in a stackful fiber, with the same `begin()`
+    // and `end()` interface as `coroutine::Sequence_`. The producer can yield from any call
+    // depth, so e.g. a recursive traversal needs no explicit stack:
+    //
+    //  auto values_of( const Node* root )
+    //      -> Fiber_sequence_<int>
+    //  {
+    //      return Fiber_sequence_<int>( [=]( Fiber_yield_<int> yield ) { recursive_for_each( root, yield ); } );
+    //  }
+    //
+    // Unlike `coroutine::Sequence_` an exception from the producer propagates to the consumer,
+    // out of the call that resumed the producer, e.g. `++` or the first `is_finished()`.
+    //
+    // The stack comes from a `Stack_pool`, by default the one for the current thread, and the
+    // sequence must be destroyed in that pool's thread. When a started sequence is destroyed
+    // before it's finished, the pending yield throws an internal exception to unwind the
+    // fiber's stack, so the producer must not swallow exceptions with `catch( ... )` without
+    // rethrowing.
+    //
+    template< class Yield_result >
+    class Fiber_sequence_
+    {
+        using Control = impl::Fiber_control_< Yield_result >;
+
+        Fiber_sequence_( in_<Fiber_sequence_> ) = delete;
+        auto operator=( in_<Fiber_sequence_> ) = delete;
+
+        Control*    m_p_control;
+
+        void if_starting_up_start_execution() const
+        {
+            if( not m_p_control->is_started() ) { m_p_control->resume(); }
+        }
+
+    public:
+        ~Fiber_sequence_() { if( m_p_control ) { Control::destroy( m_p_control ); } }
+
+        template< class Func >
+            requires invocable<decay_t<Func>&, Fiber_yield_<Yield_result>>
+        explicit Fiber_sequence_( Func&& produce, ref_<Stack_pool> pool = Stack_pool::for_this_thread() )
+        {
+            using Control_with = impl::Fiber_control_with_< Yield_result, decay_t<Func> >;
+            static_assert( alignof( Control_with ) <= 16 );
+
+            const Stack stack = pool.acquire();
+            const uintptr_t top = uintptr_t( stack.p_end - sizeof( Control_with ) ) & ~uintptr_t( 15 );
+            try {
+                m_p_control = ::new( reinterpret_cast<void*>( top ) ) Control_with( forward<Func>( produce ), pool, stack );
+            } catch( ... ) {
+                pool.release( stack );
+                throw;
+            }
+        }
+
+        // A moved-from sequence can only be destroyed.
+        Fiber_sequence_( Fiber_sequence_&& other ) noexcept:
+            m_p_control( exchange( other.m_p_control, nullptr ) )
+        {}
+
+        // Starts execution if necessary, so that an empty sequence is reported as finished.
+        auto is_finished() const
+            -> bool
+        {
+            if_starting_up_start_execution();
+            return m_p_control->is_finished();
+        }
+
+        void advance()
+        {
+            if( m_p_control->is_finished() ) {
+                throw runtime_error( "Finished, can't advance." );
+            }
+            m_p_control->resume();
+        }
+
+        auto value() -> ref_<Yield_result>
+        {
+            if_starting_up_start_execution();
+            return m_p_control->value();
+        }
+
+        class Iterator
+        {
+            Fiber_sequence_*    m_p_generator;
+
+        public:
+            Iterator( const_<Fiber_sequence_*> p_generator = nullptr ): m_p_generator( p_generator ) {}
+
+            auto operator*() const  -> Yield_result&    { return m_p_generator->value(); }
+            auto operator++()       -> Iterator&        { m_p_generator->advance(); return *this; }
+
+            auto is_at_end() const  -> bool             { return (m_p_generator == nullptr or m_p_generator->is_finished()); }
+
+            friend
+            auto operator==( in_<Iterator> a, in_<Iterator> b )
+                -> bool
+            { return (a.m_p_generator == b.m_p_generator or (a.is_at_end() and b.is_at_end())); }
+
+            friend
+            auto operator!=( in_<Iterator> a, in_<Iterator> b ) -> bool { return not(a == b); }
+        };
+
+        auto begin()    -> Iterator { return Iterator( this ); }
+        auto end()      -> Iterator { return Iterator(); }
+    };
+}  // namespace cpp_machinery::fiber
@@ -0,0 +1,113 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, ref_
+
+#include <errno.h>      // errno
+#include <stddef.h>     // size_t
+#include <sys/mman.h>   // mmap, mprotect, munmap
+#include <unistd.h>     // sysconf
+
+#include <system_error>
+#include <vector>
+
+namespace cpp_machinery::fiber {
+    using   std::system_category, std::system_error,                               // <system_error>
+            std::vector;                                                            // <vector>
+
+    struct Stack_options
+    {
+        size_t  size                = 64*1024;  // Rounded up to whole pages, excluding the guard page.
+        bool    has_guard_page      = true;     // A `PROT_NONE` page below the stack.
+        int     n_stacks_per_slab   = 16;       // Stacks per `mmap` call.
+    };
+
+    // The usable memory of a stack, which grows down from `p_end`.
+    struct Stack{ char* p_start; char* p_end; };
+
+    // Stack_pool.
+    // Hands out fiber stacks carved from `mmap`'ed slabs, and takes them back for reuse. Only
+    // the pages that a fiber actually touches are committed, and a released stack keeps them,
+    // which makes reuse cheap. The memory is returned to the system when the pool is destroyed.
+    //
+    // Each guard page splits its slab into more memory mappings, so with guard pages the number
+    // of stacks is limited by `vm.max_map_count`, by default 65530 mappings, i.e. about 32 K
+    // stacks. Not thread safe.
+    //
+    class Stack_pool
+    {
+        Stack_pool( in_<Stack_pool> ) = delete;
+        auto operator=( in_<Stack_pool> ) = delete;
+
+        struct Slab{ void* p_start; size_t size; };
+
+        Stack_options   m_options;
+        size_t          m_page_size;
+        size_t          m_stack_size;       // Rounded up.
+        vector<Slab>    m_slabs;
+        vector<Stack>   m_free_stacks;
+        int             m_n_in_use      = 0;
+
+        auto guard_size() const -> size_t { return (m_options.has_guard_page? m_page_size : 0); }
+
+        void add_slab()
+        {
+            const size_t stride = guard_size() + m_stack_size;
+            const int n = (m_options.n_stacks_per_slab > 0? m_options.n_stacks_per_slab : 1);
+            const size_t size = n*stride;
+            void* const p = ::mmap(
+                nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0
+                );
+            if( p == MAP_FAILED ) { throw system_error( errno, system_category(), "mmap of fiber stacks" ); }
+            m_slabs.push_back( Slab{ p, size } );
+
+            // In reverse order so that `acquire` hands them out in address order.
+            for( int i = n - 1; i >= 0; --i ) {
+                char* const p_guard = static_cast<char*>( p ) + i*stride;
+                if( m_options.has_guard_page and ::mprotect( p_guard, m_page_size, PROT_NONE ) != 0 ) {
+                    throw system_error( errno, system_category(), "mprotect of fiber stack guard page" );
+                }
+                char* const p_start = p_guard + guard_size();
+                m_free_stacks.push_back( Stack{ p_start, p_start + m_stack_size } );
+            }
+        }
+
+    public:
+        ~Stack_pool()
+        {
+            for( const Slab& slab: m_slabs ) { ::munmap( slab.p_start, slab.size ); }
+        }
+
+        explicit Stack_pool( in_<Stack_options> options = {} ):
+            m_options( options ),
+            m_page_size( size_t( ::sysconf( _SC_PAGESIZE ) ) ),
+            m_stack_size( (options.size + m_page_size - 1)/m_page_size*m_page_size )
+        {}
+
+        auto options() const -> const Stack_options&    { return m_options; }
+        auto n_in_use() const -> int                    { return m_n_in_use; }
+        auto n_slabs() const -> int                     { return int( m_slabs.size() ); }
+
+        auto acquire()
+            -> Stack
+        {
+            if( m_free_stacks.empty() ) { add_slab(); }
+            const Stack result = m_free_stacks.back();
+            m_free_stacks.pop_back();
+            ++m_n_in_use;
+            return result;
+        }
+
+        void release( in_<Stack> stack )
+        {
+            m_free_stacks.push_back( stack );
+            --m_n_in_use;
+        }
+
+        // The default pool for fibers created in the current thread.
+        static auto for_this_thread()
+            -> ref_<Stack_pool>
+        {
+            thread_local auto the_pool = Stack_pool();
+            return the_pool;
+        }
+    };
+}  // namespace cpp_machinery::fiber
@@ -0,0 +1,126 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_, ref_
+#include <cpp_machinery/fiber/Stack_pool.hpp>       // Stack
+
+#include <stdint.h>     // uintptr_t
+
+#if not defined( __x86_64__ ) or defined( CPP_MACHINERY_FIBER_USE_UCONTEXT )
+#   define CPP_MACHINERY_FIBER_IS_UCONTEXT_BASED
+#   include <ucontext.h>    // getcontext, makecontext, swapcontext, ucontext_t
+#endif
+
+// Switching between execution contexts with separate stacks, i.e. stackful fibers.
+//
+// On x86-64 a context is just a saved stack pointer: the switch pushes the callee-saved
+// registers on the current stack, swaps stack pointers and pops them from the other stack,
+// which is about a dozen instructions. The MXCSR and x87 control words are not switched; a
+// fiber that changes the floating point environment changes it for the thread. Elsewhere, or
+// with `CPP_MACHINERY_FIBER_USE_UCONTEXT` defined, POSIX `swapcontext` is used, which also
+// saves and restores the signal mask with a system call per switch.
+//
+// Sanitizers are not told about the switches, so e.g. AddressSanitizer can report false
+// positives for code that runs in a fiber.
+
+namespace cpp_machinery::fiber {
+    using Entry_func = void( void* p_arg );     // Must never return; must switch away instead.
+
+    #ifndef CPP_MACHINERY_FIBER_IS_UCONTEXT_BASED
+        struct Context{ void* p_stack_top = nullptr; };
+
+        namespace impl {
+            // `void switch_stacks( void** pp_save, void* p_load )`. System V x86-64 ABI.
+            [[gnu::naked, gnu::noinline]]
+            inline void switch_stacks( void**, void* ) noexcept
+            {
+                asm(
+                    "pushq  %rbp            \n"
+                    "pushq  %rbx            \n"
+                    "pushq  %r12            \n"
+                    "pushq  %r13            \n"
+                    "pushq  %r14            \n"
+                    "pushq  %r15            \n"
+                    "movq   %rsp, (%rdi)    \n"
+                    "movq   %rsi, %rsp      \n"
+                    "popq   %r15            \n"
+                    "popq   %r14            \n"
+                    "popq   %r13            \n"
+                    "popq   %r12            \n"
+                    "popq   %rbx            \n"
+                    "popq   %rbp            \n"
+                    "retq                   \n"
+                    );
+            }
+
+            // The first switch to a new context “returns” here, with the entry function in r13
+            // and its argument in r12.
+            [[gnu::naked, gnu::noinline]]
+            inline void entry_trampoline() noexcept
+            {
+                asm(
+                    "movq   %r12, %rdi      \n"
+                    "callq  *%r13           \n"
+                    "ud2                    \n"
+                    );
+            }
+        }  // namespace impl
+
+        // Saves the current context in `from` and continues `to`.
+        inline void switch_context( ref_<Context> from, in_<Context> to ) noexcept
+        {
+            impl::switch_stacks( &from.p_stack_top, to.p_stack_top );
+        }
+
+        // Makes `context` call `f( p_arg )` on the given stack when it's switched to.
+        inline void init_context( ref_<Context> context, in_<Stack> stack, Entry_func* const f, void* const p_arg )
+        {
+            // 16 byte alignment at the trampoline's `call`, as the ABI requires.
+            auto p_top = reinterpret_cast<void**>( uintptr_t( stack.p_end ) & ~uintptr_t( 15 ) );
+            *--p_top = nullptr;                                     // Padding.
+            *--p_top = nullptr;
+            *--p_top = reinterpret_cast<void*>( &impl::entry_trampoline );  // Return address.
+            *--p_top = nullptr;                                     // rbp
+            *--p_top = nullptr;                                     // rbx
+            *--p_top = p_arg;                                       // r12
+            *--p_top = reinterpret_cast<void*>( f );                // r13
+            *--p_top = nullptr;                                     // r14
+            *--p_top = nullptr;                                     // r15
+            context.p_stack_top = p_top;
+        }
+    #else
+        // A `ucontext_t` can't be copied: on some systems it has a pointer to a part of itself.
+        struct Context{ ucontext_t uc; };
+
+        namespace impl {
+            // `makecontext` passes `int` arguments, so the pointers are passed as 32-bit halves.
+            inline void ucontext_entry( const unsigned f_hi, const unsigned f_lo, const unsigned arg_hi, const unsigned arg_lo )
+            {
+                const auto joined = []( const unsigned hi, const unsigned lo ) -> uintptr_t {
+                    return (uintptr_t( hi ) << 16 << 16) | lo;
+                };
+                const auto f = reinterpret_cast<Entry_func*>( joined( f_hi, f_lo ) );
+                f( reinterpret_cast<void*>( joined( arg_hi, arg_lo ) ) );
+            }
+        }  // namespace impl
+
+        inline void switch_context( ref_<Context> from, in_<Context> to ) noexcept
+        {
+            ::swapcontext( &from.uc, &to.uc );
+        }
+
+        inline void init_context( ref_<Context> context, in_<Stack> stack, Entry_func* const f, void* const p_arg )
+        {
+            const auto hi = []( const uintptr_t v ) -> unsigned { return unsigned( v >> 16 >> 16 ); };
+            const auto lo = []( const uintptr_t v ) -> unsigned { return unsigned( v & 0xFFFF'FFFFu ); };
+
+            ::getcontext( &context.uc );
+            context.uc.uc_stack.ss_sp = stack.p_start;
+            context.uc.uc_stack.ss_size = size_t( stack.p_end - stack.p_start );
+            context.uc.uc_link = nullptr;
+            const auto f_bits = reinterpret_cast<uintptr_t>( f );
+            const auto arg_bits = reinterpret_cast<uintptr_t>( p_arg );
+            ::makecontext( &context.uc, reinterpret_cast<void(*)()>( &impl::ucontext_entry ), 4,
+                hi( f_bits ), lo( f_bits ), hi( arg_bits ), lo( arg_bits )
+                );
+        }
+    #endif
+}  // namespace cpp_machinery::fiber
@@ -0,0 +1,3 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+
+#include <cpp_machinery/threading/Thread_pool.hpp>
@@ -0,0 +1,101 @@
+﻿#pragma once    // Source encoding: UTF-8 with BOM (π is a lowercase Greek "pi").
+#include <cpp_machinery/basic/type_builders.hpp>    // in_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cpp_machinery::threading {
+    using   std::condition_variable,                        // <condition_variable>
+            std::function,                                  // <functional>
+            std::future, std::packaged_task,                // <future>
+            std::make_shared,                               // <memory>
+            std::mutex, std::unique_lock,                   // <mutex>
+            std::queue,                                     // <queue>
+            std::jthread,                                   // <thread>
+            std::forward, std::move,                        // <utility>
+            std::vector;                                    // <vector>
+
+    // Thread_pool.
+    // A fixed number of worker threads that execute submitted tasks in FIFO order.
+    // The destructor finishes all queued tasks before joining the threads.
+    //
+    //  auto pool = Thread_pool( 4 );
+    //  auto f = pool.submit( []{ return 6*7; } );
+    //  printf( "%d\n", f.get() );
+    //
+    class Thread_pool
+    {
+        Thread_pool( in_<Thread_pool> ) = delete;
+        auto operator=( in_<Thread_pool> ) = delete;
+
+        mutex                       m_mutex;
+        condition_variable          m_task_available;
+        queue<function<void()>>     m_tasks;
+        bool                        m_is_stopping   = false;
+        vector<jthread>             m_threads;
+
+        void serve()
+        {
+            for( ;; ) {
+                function<void()> task;
+                {
+                    auto lock = unique_lock( m_mutex );
+                    m_task_available.wait( lock, [this]{ return m_is_stopping or not m_tasks.empty(); } );
+                    if( m_tasks.empty() ) { return; }       // Stopping.
+                    task = move( m_tasks.front() );
+                    m_tasks.pop();
+                }
+                task();
+            }
+        }
+
+    public:
+        ~Thread_pool()
+        {
+            {
+                auto lock = unique_lock( m_mutex );
+                m_is_stopping = true;
+            }
+            m_task_available.notify_all();
+            // The `jthread` destructors join.
+        }
+
+        explicit Thread_pool( const int n_threads = int( jthread::hardware_concurrency() ) )
+        {
+            const int n = (n_threads > 0? n_threads : 1);
+            m_threads.reserve( n );
+            for( int i = 0; i < n; ++i ) { m_threads.emplace_back( [this]{ serve(); } ); }
+        }
+
+        auto n_threads() const -> int { return int( m_threads.size() ); }
+
+        // Fire and forget.
+        void post( function<void()> task )
+        {
+            {
+                auto lock = unique_lock( m_mutex );
+                m_tasks.push( move( task ) );
+            }
+            m_task_available.notify_one();
+        }
+
+        template< class Func >
+        auto submit( Func&& f )
+            -> future<decltype( f() )>
+        {
+            using Result = decltype( f() );
+            // `function` requires a copyable callable, hence the shared `packaged_task`.
+            auto p_task = make_shared<packaged_task<Result()>>( forward<Func>( f ) );
+            auto result = p_task->get_future();
+            post( [p_task]{ (*p_task)(); } );
+            return result;
+        }
+    };
+}  // namespace cpp_machinery::threading
@@ -0,0 +1,159 @@
+#include <cpp_machinery/_all.hpp>
+
+#include <errno.h>      // errno
+#include <stdio.h>      // FILE, fclose, ferror, fgets, fopen, fprintf, printf
+#include <stdlib.h>     // EXIT_FAILURE, EXIT_SUCCESS
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// An `Async_sequence_` of the lines of a file. The blocking reads are done in a thread pool,
+// and meanwhile the run loop's thread is free to run other coroutines, here a “ticker”.
+
+namespace app {
+    namespace cppm = cpp_machinery;
+    using   cppm::const_, cppm::in_, cppm::ref_;
+    using   cppm::coroutine::Async_sequence_, cppm::coroutine::Frame_budget, cppm::coroutine::Run_loop,
+            cppm::coroutine::Task;
+    using   cppm::threading::Thread_pool;
+    using   std::coroutine_handle,          // <coroutine>
+            std::current_exception, std::exception_ptr, std::rethrow_exception,    // <exception>
+            std::unique_ptr,                // <memory>
+            std::optional,                  // <optional>
+            std::string,                    // <string>
+            std::system_category, std::system_error,    // <system_error>
+            std::move;                      // <utility>
+
+    struct File_closer{ void operator()( const_<FILE*> f ) const { fclose( f ); } };
+    using File_ptr = unique_ptr<FILE, File_closer>;
+
+    // Reads a line of any length, without the newline. Empty at the end of the file.
+    auto line_from( const_<FILE*> f )
+        -> optional<string>
+    {
+        string line;
+        char buffer[1024];
+        bool has_data = false;
+        while( fgets( buffer, sizeof( buffer ), f ) ) {
+            has_data = true;
+            line += buffer;
+            if( line.back() == '\n' ) {
+                line.pop_back();
+                return line;
+            }
+        }
+        if( ferror( f ) ) { throw system_error( errno, system_category(), "Reading a line" ); }
+        if( not has_data ) { return {}; }
+        return line;        // The last line, with no newline at the end.
+    }
+
+    // Awaitable that reads a line in the pool, then resumes the awaiting coroutine via the loop.
+    // A read error is rethrown in the awaiting coroutine. Not cancellable: the awaiting coroutine
+    // must not be destroyed, e.g. by `Run_loop::with_deadline`, while a read is in progress.
+    struct Line_reading
+    {
+        Run_loop&           loop;
+        Thread_pool&        pool;
+        FILE*               f;
+        optional<string>    line        = {};
+        exception_ptr       x_ptr       = {};
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        void await_suspend( const coroutine_handle<> h )
+        {
+            pool.post( [this, h]{
+                try {
+                    line = line_from( f );
+                } catch( ... ) {
+                    x_ptr = current_exception();
+                }
+                loop.post( h );
+            } );
+        }
+
+        auto await_resume()
+            -> optional<string>
+        {
+            if( x_ptr ) { rethrow_exception( x_ptr ); }
+            return move( line );
+        }
+    };
+
+    // The file is closed also when the consumer stops early and destroys the sequence.
+    // Failing to open the file is an exception, thrown from the first `next()`.
+    auto lines_of( ref_<Run_loop> loop, ref_<Thread_pool> pool, const char* const path )
+        -> Async_sequence_<string>
+    {
+        const auto f = File_ptr( fopen( path, "r" ) );
+        if( not f ) { throw system_error( errno, system_category(), string( "Opening “" ) + path + "”" ); }
+        for( ;; ) {
+            optional<string> line = co_await Line_reading{ loop, pool, f.get() };
+            if( not line ) { break; }
+            co_yield move( *line );
+        }
+    }
+    const auto lines_of_budget = Frame_budget( "lines_of", 384, []{
+        static auto loop = Run_loop();
+        static auto pool = Thread_pool( 1 );
+        return lines_of( loop, pool, "" );
+    } );
+
+    // Sets `done` also on failure, so that the ticker stops.
+    auto display_lines( ref_<Run_loop> loop, ref_<Thread_pool> pool, const char* const path, ref_<bool> done )
+        -> Task
+    {
+        try {
+            auto lines = lines_of( loop, pool, path );
+            int n = 0;
+            while( const optional<string> line = co_await lines.next() ) {
+                ++n;
+                if( n <= 5 ) { printf( "%3d: %s\n", n, line->c_str() ); }
+            }
+            printf( "%d lines in total.\n", n );
+        } catch( ... ) {
+            done = true;
+            throw;
+        }
+        done = true;
+    }
+
+    auto ticker( ref_<Run_loop> loop, in_<bool> done, ref_<int> n_ticks )
+        -> Task
+    {
+        while( not done ) {
+            ++n_ticks;
+            co_await loop.next_turn();
+        }
+    }
+
+    void run( const char* const path )
+    {
+        auto loop = Run_loop();
+        auto pool = Thread_pool( 1 );
+        bool done = false;
+        int n_ticks = 0;
+        auto reader = display_lines( loop, pool, path, done );
+        auto other = ticker( loop, done, n_ticks );
+        loop.post( other.handle() );
+        loop.run_until( [&]{ return reader.is_done() and other.is_done(); }, reader.handle() );
+        reader.result();        // Rethrows any exception, e.g. from opening the file.
+        printf( "The ticker ran %d times while lines were read.\n", n_ticks );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    try {
+        app::run( n_args > 1? args[1] : __FILE__ );
+        return EXIT_SUCCESS;
+    } catch( const std::exception& x ) {
+        fprintf( stderr, "!%s\n", x.what() );
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,274 @@
+#include <cpp_machinery/_all.hpp>
+
+#include <linux/perf_event.h>   // perf_event_attr, PERF_*
+#include <stdint.h>     // uint64_t
+#include <stdio.h>      // printf, snprintf
+#include <stdlib.h>     // atoi, EXIT_SUCCESS
+#include <string.h>     // memset
+#include <sys/syscall.h>        // SYS_perf_event_open
+#include <unistd.h>     // close, read, syscall
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Pipelines of sequences with their coroutine frames on the heap versus in a `Frame_arena`:
+// the setup and teardown latency of a short lived pipeline, and the consumption of many
+// live pipelines in turn, where the frames' locality matters. Linux only, because the cache
+// misses are counted with `perf_event_open`, when the hardware counters are available.
+//
+// The heap pipelines use ordinary coroutines, so they're the baseline. The arena pipelines
+// use the same coroutines with `allocator_arg, arena` as the first arguments.
+
+namespace app {
+    namespace cppm = cpp_machinery;
+    using   cppm::const_, cppm::in_, cppm::ref_;
+    using   cppm::coroutine::Frame_arena, cppm::coroutine::Frame_budget, cppm::coroutine::Sequence_;
+    using   std::allocator_arg, std::allocator_arg_t,       // <memory>
+            std::unique_ptr, std::make_unique,              // <memory>
+            std::mt19937, std::uniform_int_distribution,    // <random>
+            std::move, std::swap,                           // <utility>
+            std::vector;                                    // <vector>
+    namespace chrono = std::chrono;
+    using Clock = chrono::steady_clock;
+
+    auto numbers( const int n )
+        -> Sequence_<int>
+    {
+        for( int i = 1; i <= n; ++i ) { co_yield i; }
+    }
+    const auto numbers_budget = Frame_budget( "numbers", 96, []{ return numbers( 0 ); } );
+
+    auto offset( Sequence_<int> source, const int delta )
+        -> Sequence_<int>
+    {
+        for( const int v: source ) { co_yield v + delta; }
+    }
+    const auto offset_budget = Frame_budget( "offset", 160, []{ return offset( numbers( 0 ), 0 ); } );
+
+    // `n_stages` offsetting stages on top of a `numbers( n )` source.
+    auto pipeline( const int n_stages, const int n )
+        -> Sequence_<int>
+    { return (n_stages == 0? numbers( n ) : offset( pipeline( n_stages - 1, n ), 1 )); }
+
+    // The same, with the frames in `arena`.
+
+    auto numbers( allocator_arg_t, ref_<Frame_arena>, const int n )
+        -> Sequence_<int>
+    {
+        for( int i = 1; i <= n; ++i ) { co_yield i; }
+    }
+
+    auto offset( allocator_arg_t, ref_<Frame_arena>, Sequence_<int> source, const int delta )
+        -> Sequence_<int>
+    {
+        for( const int v: source ) { co_yield v + delta; }
+    }
+
+    auto pipeline( allocator_arg_t, ref_<Frame_arena> arena, const int n_stages, const int n )
+        -> Sequence_<int>
+    {
+        return (n_stages == 0
+            ? numbers( allocator_arg, arena, n )
+            : offset( allocator_arg, arena, pipeline( allocator_arg, arena, n_stages - 1, n ), 1 )
+            );
+    }
+
+    auto pipeline( const int n_stages, const int n, const_<Frame_arena*> p_arena )
+        -> Sequence_<int>
+    { return (p_arena? pipeline( allocator_arg, *p_arena, n_stages, n ) : pipeline( n_stages, n )); }
+
+    // L1 data cache read misses and last level cache misses, if the hardware counters are
+    // available; they're usually not in a virtual machine.
+    class Cache_misses
+    {
+        Cache_misses( in_<Cache_misses> ) = delete;
+        auto operator=( in_<Cache_misses> ) = delete;
+
+        int     m_fds[2];
+
+        static auto opened_counter( const uint32_t type, const uint64_t config )
+            -> int
+        {
+            perf_event_attr attr;
+            memset( &attr, 0, sizeof( attr ) );
+            attr.size = sizeof( attr );
+            attr.type = type;
+            attr.config = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            return int( ::syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 ) );
+        }
+
+        auto count( const int i ) const
+            -> long long
+        {
+            uint64_t value = 0;
+            if( m_fds[i] < 0 or ::read( m_fds[i], &value, sizeof( value ) ) != sizeof( value ) ) { return -1; }
+            return (long long) value;
+        }
+
+    public:
+        ~Cache_misses() { for( const int fd: m_fds ) { if( fd >= 0 ) { ::close( fd ); } } }
+
+        Cache_misses():
+            m_fds{
+                opened_counter( PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) ),
+                opened_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES )
+                }
+        {}
+
+        auto l1d() const -> long long   { return count( 0 ); }
+        auto llc() const -> long long   { return count( 1 ); }
+    };
+
+    struct Measurement
+    {
+        double      seconds     = 0;
+        long long   l1d_misses  = 0;
+        long long   llc_misses  = 0;
+
+        template< class Func >
+        void add( in_<Cache_misses> counters, in_<Func> f )
+        {
+            const long long l1d_before = counters.l1d();
+            const long long llc_before = counters.llc();
+            const auto start = Clock::now();
+            f();
+            seconds += chrono::duration<double>( Clock::now() - start ).count();
+            l1d_misses = (l1d_before < 0 or l1d_misses < 0? -1 : l1d_misses + counters.l1d() - l1d_before);
+            llc_misses = (llc_before < 0 or llc_misses < 0? -1 : llc_misses + counters.llc() - llc_before);
+        }
+
+        void display( const char* const what, const double n_units, const char* const unit ) const
+        {
+            char misses[64] = "cache misses n/a";
+            if( l1d_misses >= 0 and llc_misses >= 0 ) {
+                snprintf( misses, sizeof( misses ), "L1D misses %6.2f, LLC misses %6.2f",
+                    l1d_misses/n_units, llc_misses/n_units
+                    );
+            }
+            printf( "    %-12s %8.1f ns, %s per %s.\n", what, 1e9*seconds/n_units, misses, unit );
+        }
+    };
+
+    // Builds, consumes and tears down `n_pipelines` pipelines, one at a time.
+    void measure_short_lived( in_<Cache_misses> counters, const int n_pipelines, const int n_stages, const int n,
+        Frame_arena* const p_arena )
+    {
+        Measurement setup, consumption, teardown;
+        long long sum = 0;
+        for( int i = 0; i < n_pipelines; ++i ) {
+            alignas( Sequence_<int> ) char storage[sizeof( Sequence_<int> )];
+            Sequence_<int>* p_pipeline = nullptr;
+            setup.add( counters, [&]{
+                p_pipeline = ::new( storage ) Sequence_<int>( pipeline( n_stages, n, p_arena ) );
+            } );
+            consumption.add( counters, [&]{ for( const int v: *p_pipeline ) { sum += v; } } );
+            teardown.add( counters, [&]{
+                p_pipeline->~Sequence_<int>();
+                if( p_arena ) { p_arena->reset(); }
+            } );
+        }
+        printf( "  %s, sum %lld:\n", (p_arena? "Frames in an arena" : "Frames on the heap"), sum );
+        setup.display( "Setup:", n_pipelines, "pipeline" );
+        consumption.display( "Consumption:", n_pipelines, "pipeline" );
+        teardown.display( "Teardown:", n_pipelines, "pipeline" );
+    }
+
+    // The bytes used by the frames of one pipeline.
+    auto arena_size_for( const int n_stages, const int n )
+        -> size_t
+    {
+        auto arena = Frame_arena();
+        const auto probe = pipeline( allocator_arg, arena, n_stages, n );
+        return arena.n_allocated();
+    }
+
+    // Builds `n_pipelines` pipelines, then consumes them one value from each at a time. An arena
+    // that's much bigger than the frames would spread the pipelines out in memory, so each arena
+    // is sized to fit just one pipeline.
+    void measure_many_live( in_<Cache_misses> counters, const int n_pipelines, const int n_stages, const int n,
+        const bool use_arenas )
+    {
+        Measurement setup, consumption, teardown;
+        const size_t arena_size = arena_size_for( n_stages, n );
+        vector<unique_ptr<Frame_arena>> arenas;
+        vector<Sequence_<int>> pipelines;
+        pipelines.reserve( n_pipelines );
+        setup.add( counters, [&]{
+            for( int i = 0; i < n_pipelines; ++i ) {
+                if( use_arenas ) {
+                    arenas.push_back( make_unique<Frame_arena>( arena_size ) );
+                    pipelines.push_back( pipeline( allocator_arg, *arenas.back(), n_stages, n ) );
+                } else {
+                    pipelines.push_back( pipeline( n_stages, n ) );
+                }
+            }
+        } );
+        long long sum = 0;
+        consumption.add( counters, [&]{
+            vector<Sequence_<int>::Iterator> its;
+            its.reserve( n_pipelines );
+            for( Sequence_<int>& p: pipelines ) { its.push_back( p.begin() ); }
+            for( int i = 0; i < n; ++i ) {
+                for( Sequence_<int>::Iterator& it: its ) { sum += *it;  ++it; }
+            }
+        } );
+        teardown.add( counters, [&]{ pipelines.clear();  arenas.clear(); } );
+        if( use_arenas ) {
+            printf( "  Frames in a %zu bytes arena per pipeline, sum %lld:\n", arena_size, sum );
+        } else {
+            printf( "  Frames on the heap, sum %lld:\n", sum );
+        }
+        setup.display( "Setup:", n_pipelines, "pipeline" );
+        consumption.display( "Consumption:", double( n_pipelines )*n, "value" );
+        teardown.display( "Teardown:", n_pipelines, "pipeline" );
+    }
+
+    // Leaves the heap with free blocks of various sizes scattered between live blocks, as in a
+    // long running program, so that new allocations are no longer simply consecutive.
+    auto fragmented_heap_blocks()
+        -> vector<unique_ptr<char[]>>
+    {
+        auto random = mt19937( 42 );
+        auto size = uniform_int_distribution<int>( 16, 256 );
+        vector<unique_ptr<char[]>> blocks( 400'000 );
+        for( unique_ptr<char[]>& block: blocks ) { block = make_unique<char[]>( size( random ) ); }
+        for( int i = 0; i < int( blocks.size() ); i += 2 ) { blocks[i] = nullptr; }
+        return blocks;
+    }
+
+    void run( const int n_stages )
+    {
+        const auto counters = Cache_misses();
+
+        const int n_short_lived = 100'000;
+        printf( "%d short lived pipelines of %d stages, each with 16 values:\n", n_short_lived, n_stages );
+        measure_short_lived( counters, n_short_lived, n_stages, 16, nullptr );
+        {
+            auto arena = Frame_arena();
+            measure_short_lived( counters, n_short_lived, n_stages, 16, &arena );
+        }
+
+        const int n_live = 10'000;
+        printf( "\n%d live pipelines of %d stages, each with 100 values, consumed in turn:\n", n_live, n_stages );
+        measure_many_live( counters, n_live, n_stages, 100, false );
+        measure_many_live( counters, n_live, n_stages, 100, true );
+        const auto blocks = fragmented_heap_blocks();
+        printf( "  After fragmenting the heap:\n" );
+        measure_many_live( counters, n_live, n_stages, 100, false );
+        measure_many_live( counters, n_live, n_stages, 100, true );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        return EXIT_SUCCESS;        // The budgets are measured at startup; the work is skipped.
+    #endif
+    app::run( n_args > 1? atoi( args[1] ) : 8 );
+}
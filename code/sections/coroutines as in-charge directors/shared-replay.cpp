@@ -0,0 +1,91 @@
+#include <cpp_machinery/coroutine.hpp>
+#include <stdio.h>
+#include <exception>    // std::exception
+#include <stdexcept>    // std::runtime_error
+namespace coroutine = cpp_machinery::coroutine;
+
+int n_values_computed = 0;
+
+// Stands in for an expensive producer.
+auto squares( const int n ) -> coroutine::Sequence_<int>
+{
+    for( int i = 1; i <= n; ++i ) {
+        ++n_values_computed;
+        co_yield i*i;
+    }
+}
+const auto squares_budget = coroutine::Frame_budget( "squares", 128, []{ return squares( 0 ); } );
+
+// Fails after `n` values, e.g. with `n` = 0 as if a file couldn't be opened.
+auto failing_squares( const int n ) -> coroutine::Sequence_<int>
+{
+    for( int i = 1; i <= n; ++i ) { co_yield i*i; }
+    throw std::runtime_error( "Producer failed." );
+}
+
+void display_sum_of( coroutine::Shared_replay_<int>::Cursor cursor, const char* const name )
+{
+    long long sum = 0;
+    for( const int v: cursor ) { sum += v; }
+    printf( "  %s: sum %lld, %d values computed so far.\n", name, sum, n_values_computed );
+}
+
+auto main() -> int
+{
+    printf( "Several consumers, one run of the producer:\n" );
+    {
+        auto replay = coroutine::shared_replay( squares( 1000 ) );
+        auto first = replay.cursor();
+        for( const int v: first ) { if( v > 100 ) { break; } }
+        printf( "  First consumer stopped at position %d, %d values computed.\n",
+            int( first.position() ), n_values_computed
+            );
+        display_sum_of( replay.cursor(), "Second consumer" );
+        display_sum_of( replay.cursor(), "Third consumer" );
+        printf( "  %d values cached.\n", int( replay.n_cached() ) );
+    }
+
+    printf( "Dropping the chunks that all cursors have passed:\n" );
+    n_values_computed = 0;
+    {
+        auto options = coroutine::Replay_options();
+        options.chunk_size = 64;
+        options.drop_passed_chunks = true;
+        auto replay = coroutine::shared_replay( squares( 30'000 ), options );
+        auto a = replay.cursor();
+        auto b = replay.cursor();
+        long long sum_a = 0;
+        long long sum_b = 0;
+        int max_n_cached = 0;
+        for( ; not a.is_at_end(); a.advance() ) {
+            sum_a += a.value();
+            if( a.position() % 3 == 0 ) {       // `b` lags behind, at a third of the speed.
+                sum_b += b.value();  b.advance();
+            }
+            if( int( replay.n_cached() ) > max_n_cached ) { max_n_cached = int( replay.n_cached() ); }
+        }
+        for( ; not b.is_at_end(); b.advance() ) { sum_b += b.value(); }
+        printf( "  Sums %lld and %lld, %d values computed, at most %d cached, %d cached at end.\n",
+            sum_a, sum_b, n_values_computed, max_n_cached, int( replay.n_cached() )
+            );
+    }
+
+    printf( "A producer that fails, which is not the same as an empty sequence:\n" );
+    for( const int n: {0, 3} ) {
+        try {
+            for( const int v: failing_squares( n ) ) { (void) v; }
+            printf( "  Sequence_, %d values: no exception!\n", n );
+        } catch( const std::exception& x ) {
+            printf( "  Sequence_, %d values: “%s”\n", n, x.what() );
+        }
+        auto replay = coroutine::shared_replay( failing_squares( n ) );
+        for( const char* const name: {"First cursor", "Second cursor"} ) {
+            try {
+                display_sum_of( replay.cursor(), name );
+                printf( "  %s, %d values: no exception!\n", name, n );
+            } catch( const std::exception& x ) {
+                printf( "  %s, %d values: “%s”\n", name, n, x.what() );
+            }
+        }
+    }
+}
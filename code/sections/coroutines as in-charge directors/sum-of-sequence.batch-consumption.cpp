@@ -0,0 +1,55 @@
+#include <cpp_machinery/coroutine.hpp>
+#include <stdint.h>     // int64_t
+#include <stdio.h>      // printf
+#include <stdlib.h>     // atoi, EXIT_SUCCESS
+#include <chrono>
+#include <span>
+namespace coroutine = cpp_machinery::coroutine;
+namespace seq       = cpp_machinery::coroutine::seq;
+namespace chrono    = std::chrono;
+
+// Like `numbers` in "sum-of-sequence.cpp", but with values that don't overflow for big `n`.
+auto numbers( const int n ) -> coroutine::Sequence_<int>
+{
+    for( int i = 1; i <= n; ++i ) { co_yield i % 1000; }
+}
+const auto numbers_budget = coroutine::Frame_budget( "numbers", 128, []{ return numbers( 0 ); } );
+
+template< class Func >
+void time( const char* const what, const int n, const Func& f )
+{
+    const auto start = chrono::steady_clock::now();
+    const int64_t result = f();
+    const double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+    printf( "  %-32s %lld, %7.3f s, %7.1f M values/s.\n", what, (long long) result, seconds, n/seconds/1e6 );
+}
+
+auto main( const int n_args, char** args ) -> int
+{
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        return EXIT_SUCCESS;        // The budgets are measured at startup; the work is skipped.
+    #endif
+    const int n = (n_args > 1? atoi( args[1] ) : 100'000'000);
+    printf( "Consuming %d values.\n", n );
+
+    time( "Range based `for`:", n, [n]() -> int64_t {
+        int64_t sum = 0;
+        for( const int v: numbers( n ) ) { sum += v; }
+        return sum;
+    } );
+    time( "seq::sum:", n, [n]{ return seq::sum( numbers( n ) ); } );
+    time( "seq::reduce:", n, [n]{
+        return seq::reduce( numbers( n ), int64_t(), []( const int64_t a, const int v ) { return a + v; } );
+    } );
+    time( "seq::for_each_batch:", n, [n]{
+        int64_t sum = 0;
+        seq::for_each_batch( numbers( n ), [&]( const std::span<const int> batch ) {
+            for( const int v: batch ) { sum += v; }
+        } );
+        return sum;
+    } );
+    time( "seq::max_of:", n, [n]() -> int64_t { return seq::max_of( numbers( n ) ); } );
+    time( "seq::count_if (v < 500):", n, [n]() -> int64_t {
+        return seq::count_if( numbers( n ), []( const int v ) { return v < 500; } );
+    } );
+}
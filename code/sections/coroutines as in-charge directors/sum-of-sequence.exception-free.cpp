@@ -0,0 +1,40 @@
+#include <cpp_machinery/coroutine/Checked_sequence_.hpp>
+#include <cpp_machinery/coroutine/Frame_budget.hpp>
+#include <limits.h>     // INT_MAX
+#include <stdio.h>
+#include <system_error> // std::errc, std::make_error_code
+namespace coroutine = cpp_machinery::coroutine;
+using std::errc;
+
+// Compiles also with `-fno-exceptions`. Overflow is reported via the sequence's error value.
+auto numbers( const int n ) -> coroutine::Checked_sequence_<int, errc>
+{
+    int sum = 0;
+    for( int i = 1; i <= n; ++i ) {
+        if( sum > INT_MAX - i ) { co_return errc::value_too_large; }
+        sum += i;
+        co_yield sum;
+    }
+    co_return {};
+}
+const auto numbers_budget = coroutine::Frame_budget( "numbers", 96, []{ return numbers( 0 ); } );
+
+void display_sum_of_numbers( const int n )
+{
+    long long sum = 0;
+    auto seq = numbers( n );
+    for( const int v: seq ) { sum += v; }
+    if( seq.has_error() ) {
+        printf( "n = %d: error “%s” after sum %lld.\n",
+            n, std::make_error_code( seq.error() ).message().c_str(), sum
+            );
+    } else {
+        printf( "n = %d: %lld\n", n, sum );
+    }
+}
+
+auto main() -> int
+{
+    display_sum_of_numbers( 7 );
+    display_sum_of_numbers( 100'000 );
+}
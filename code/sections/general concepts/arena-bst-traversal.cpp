@@ -0,0 +1,290 @@
+#include <cpp_machinery/_all.hpp>
+
+#include <stdint.h>     // uint32_t
+#include <stdio.h>      // printf
+#include <stdlib.h>     // atoi, EXIT_SUCCESS
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <stack>
+#include <vector>
+
+// The BST from "stackful-vs-stackless-bst-traversal.cpp" allocates each node with its own
+// `new`, so a traversal is pointer chasing all over the heap. Here the nodes instead live in a
+// single contiguous arena, are referred to by 32-bit indices, and a bulk build lays them out
+// in Eytzinger (BFS) order, where the children of node k are nodes 2k and 2k + 1.
+
+namespace bst {
+    namespace cppm = cpp_machinery;
+    using   cppm::const_, cppm::in_, cppm::ref_, cppm::popped_top_of, cppm::is_empty;
+    using   cppm::coroutine::Frame_budget, cppm::coroutine::Sequence_;
+    using   std::stack,             // <stack>
+            std::vector;            // <vector>
+
+    // Classic pointer based node, as in "stackful-vs-stackless-bst-traversal.cpp".
+    struct Node{ int value; Node* left; Node* right; };
+
+    void insert( const int new_value, ref_<Node*> root )
+    {
+        const_<Node*> new_node = new Node{ new_value, nullptr, nullptr };
+        if( not root ) {
+            root = new_node;
+            return;
+        }
+        Node* current = root;
+        for( ;; ) {
+            ref_<Node*> child = (new_value < current->value? current->left : current->right);
+            if( not child ) {
+                child = new_node;
+                break;
+            } else {
+                current = child;
+            }
+        }
+    }
+
+    void destroy( const_<Node*> root )
+    {
+        if( root ) { destroy( root->left );  destroy( root->right );  delete root; }
+    }
+
+    template< class Func >
+    void recursive_for_each( const_<Node*> root, in_<Func> consume )
+    {
+        if( root ) {
+            recursive_for_each( root->left, consume );
+            consume( root->value );
+            recursive_for_each( root->right, consume );
+        }
+    }
+
+    // Arena based tree. Index 0 is the null index, so node indices start at 1.
+    class Arena_tree
+    {
+    public:
+        using Index = uint32_t;
+        struct Node{ int value; Index left; Index right; };
+
+        static constexpr Index null_index = 0;
+
+    private:
+        vector<Node>    m_nodes     = vector<Node>( 1 );       // Slot 0 is the null node.
+        Index           m_root      = null_index;
+        bool            m_is_eytzinger_ordered  = true;         // Trivially true when empty.
+
+    public:
+        auto size() const       -> Index            { return Index( m_nodes.size() - 1 ); }
+        auto root() const       -> Index            { return m_root; }
+        auto node( const Index i ) const -> in_<Node>   { return m_nodes[i]; }
+
+        // Whether node k has children 2k and 2k + 1, i.e. the layout supports stackless traversal.
+        auto is_eytzinger_ordered() const -> bool   { return m_is_eytzinger_ordered; }
+
+        void reserve( const Index n ) { m_nodes.reserve( n + 1 ); }
+
+        void insert( const int new_value )
+        {
+            const Index new_index = Index( m_nodes.size() );
+            m_nodes.push_back( Node{ new_value, null_index, null_index } );
+            m_is_eytzinger_ordered = false;
+            if( m_root == null_index ) {
+                m_root = new_index;
+                m_is_eytzinger_ordered = true;
+                return;
+            }
+            Index current = m_root;
+            for( ;; ) {
+                ref_<Node> node = m_nodes[current];
+                ref_<Index> child = (new_value < node.value? node.left : node.right);
+                if( child == null_index ) {
+                    child = new_index;
+                    break;
+                } else {
+                    current = child;
+                }
+            }
+        }
+
+        // A complete BST of the ascending `sorted_values`, laid out in Eytzinger order.
+        // An in-order walk of positions 1…n assigns the values.
+        static auto from_sorted( in_<vector<int>> sorted_values )
+            -> Arena_tree
+        {
+            Arena_tree result;
+            const Index n = Index( sorted_values.size() );
+            result.m_nodes.resize( n + 1 );
+            for( Index k = 1; k <= n; ++k ) {
+                const Index left    = 2*k;
+                const Index right   = 2*k + 1;
+                result.m_nodes[k] = Node{ 0, (left <= n? left : null_index), (right <= n? right : null_index) };
+            }
+            Index k = first_in_order( n );
+            for( const int v: sorted_values ) {
+                result.m_nodes[k].value = v;
+                k = next_in_order( k, n );
+            }
+            result.m_root = (n > 0? 1 : null_index);
+            result.m_is_eytzinger_ordered = true;
+            return result;
+        }
+
+        // Stackless in-order navigation for an Eytzinger layout of `n` nodes.
+        static auto first_in_order( const Index n )
+            -> Index
+        {
+            if( n == 0 ) { return null_index; }
+            Index k = 1;
+            while( 2*k <= n ) { k *= 2; }
+            return k;
+        }
+
+        static auto next_in_order( Index k, const Index n )
+            -> Index
+        {
+            if( 2*k + 1 <= n ) {
+                k = 2*k + 1;
+                while( 2*k <= n ) { k *= 2; }
+                return k;
+            }
+            while( k & 1 ) { k >>= 1; }     // Up while coming from a right child.
+            return k >> 1;                  // 0, i.e. `null_index`, when done.
+        }
+    };
+
+    template< class Func >
+    void recursive_for_each( in_<Arena_tree> tree, const Arena_tree::Index i, in_<Func> consume )
+    {
+        if( i != Arena_tree::null_index ) {
+            const auto& node = tree.node( i );
+            recursive_for_each( tree, node.left, consume );
+            consume( node.value );
+            recursive_for_each( tree, node.right, consume );
+        }
+    }
+
+    template< class Func >
+    void recursive_for_each( in_<Arena_tree> tree, in_<Func> consume )
+    {
+        recursive_for_each( tree, tree.root(), consume );
+    }
+
+    // Iterative traversal: index arithmetic for an Eytzinger layout, else an explicit stack.
+    template< class Func >
+    void iterative_for_each( in_<Arena_tree> tree, in_<Func> consume )
+    {
+        using Index = Arena_tree::Index;
+        if( tree.is_eytzinger_ordered() ) {
+            const Index n = tree.size();
+            for( Index k = Arena_tree::first_in_order( n ); k != Arena_tree::null_index;
+                    k = Arena_tree::next_in_order( k, n ) ) {
+                consume( tree.node( k ).value );
+            }
+            return;
+        }
+        auto    parents     = stack<Index>();
+        Index   current     = tree.root();
+        while( current != Arena_tree::null_index or not is_empty( parents ) ) {
+            while( current != Arena_tree::null_index ) {
+                parents.push( current );
+                current = tree.node( current ).left;
+            }
+            const Index i = popped_top_of( parents );
+            consume( tree.node( i ).value );
+            current = tree.node( i ).right;
+        }
+    }
+
+    // Coroutine traversal, with the same stackless index navigation as `iterative_for_each`.
+    auto values_of( in_<Arena_tree> tree )
+        -> Sequence_<int>
+    {
+        using Index = Arena_tree::Index;
+        if( tree.is_eytzinger_ordered() ) {
+            const Index n = tree.size();
+            for( Index k = Arena_tree::first_in_order( n ); k != Arena_tree::null_index;
+                    k = Arena_tree::next_in_order( k, n ) ) {
+                co_yield tree.node( k ).value;
+            }
+        } else {
+            auto    parents     = stack<Index>();
+            Index   current     = tree.root();
+            while( current != Arena_tree::null_index or not is_empty( parents ) ) {
+                while( current != Arena_tree::null_index ) {
+                    parents.push( current );
+                    current = tree.node( current ).left;
+                }
+                const Index i = popped_top_of( parents );
+                co_yield tree.node( i ).value;
+                current = tree.node( i ).right;
+            }
+        }
+    }
+    const auto values_of_budget = Frame_budget( "arena values_of", 256, []{
+        static const auto empty_tree = Arena_tree();
+        return values_of( empty_tree );
+    } );
+}  // namespace bst
+
+namespace app {
+    using   cpp_machinery::in_;
+    using   std::shuffle,                                   // <algorithm>
+            std::iota,                                      // <numeric>
+            std::mt19937,                                   // <random>
+            std::vector;                                    // <vector>
+    namespace chrono = std::chrono;
+
+    // `sum` is read after `f` has run.
+    template< class Func >
+    void time( const char* const what, const int n, in_<long long> sum, in_<Func> f )
+    {
+        const auto start = chrono::steady_clock::now();
+        f();
+        const double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+        printf( "  %-40s sum %lld, %7.3f s, %7.1f M values/s.\n", what, sum, seconds, n/seconds/1e6 );
+    }
+
+    void run( const int n )
+    {
+        printf( "Traversing %d values.\n", n );
+        auto values = vector<int>( n );
+        iota( values.begin(), values.end(), 1 );
+        auto shuffled = values;
+        shuffle( shuffled.begin(), shuffled.end(), mt19937( 42 ) );
+
+        bst::Node* root = nullptr;
+        for( const int v: shuffled ) { bst::insert( v, root ); }
+
+        auto inserted = bst::Arena_tree();
+        inserted.reserve( n );
+        for( const int v: shuffled ) { inserted.insert( v ); }
+
+        const auto eytzinger = bst::Arena_tree::from_sorted( values );
+
+        long long sum = 0;
+        const auto add = [&sum]( const int v ) { sum += v; };
+
+        time( "Pointer nodes, recursive:", n, sum, [&]{ sum = 0; bst::recursive_for_each( root, add ); } );
+        time( "Arena (insertion order), recursive:", n, sum, [&]{ sum = 0; bst::recursive_for_each( inserted, add ); } );
+        time( "Arena (insertion order), iterative:", n, sum, [&]{ sum = 0; bst::iterative_for_each( inserted, add ); } );
+        time( "Arena (insertion order), coroutine:", n, sum,
+            [&]{ sum = 0; for( const int v: bst::values_of( inserted ) ) { sum += v; } } );
+        time( "Arena (Eytzinger), recursive:", n, sum, [&]{ sum = 0; bst::recursive_for_each( eytzinger, add ); } );
+        time( "Arena (Eytzinger), iterative:", n, sum, [&]{ sum = 0; bst::iterative_for_each( eytzinger, add ); } );
+        time( "Arena (Eytzinger), coroutine:", n, sum,
+            [&]{ sum = 0; for( const int v: bst::values_of( eytzinger ) ) { sum += v; } } );
+
+        bst::destroy( root );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        return EXIT_SUCCESS;        // The budgets are measured at startup; the work is skipped.
+    #endif
+    const int n = (n_args > 1? atoi( args[1] ) : 10'000'000);
+    app::run( n );
+    printf( "Finished.\n" );
+}
@@ -0,0 +1,227 @@
+#include <cpp_machinery/_all.hpp>
+
+#include <stdio.h>      // printf
+#include <stdlib.h>     // atoi, EXIT_SUCCESS
+
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <stack>
+#include <thread>
+#include <vector>
+
+// Splits a BST into an in-order list of segments — whole subtrees and the single nodes
+// between them — that are traversed concurrently on a thread pool. The per segment results
+// are combined in order, so any associative operation works, not just commutative ones.
+
+namespace bst {
+    namespace cppm = cpp_machinery;
+    using   cppm::const_, cppm::in_, cppm::ref_, cppm::popped_top_of, cppm::is_empty;
+    using   cppm::coroutine::Frame_budget, cppm::coroutine::Sequence_;
+    using   cppm::threading::Thread_pool;
+    using   std::future,            // <future>
+            std::stack,             // <stack>
+            std::vector;            // <vector>
+
+    struct Node{ int value; Node* left; Node* right; };
+
+    // Balanced tree of the ascending values in [first, beyond).
+    auto balanced_tree_of( const_<const int*> first, const_<const int*> beyond )
+        -> Node*
+    {
+        if( first == beyond ) { return nullptr; }
+        const_<const int*> middle = first + (beyond - first)/2;
+        return new Node{ *middle, balanced_tree_of( first, middle ), balanced_tree_of( middle + 1, beyond ) };
+    }
+
+    void destroy( const_<Node*> root )
+    {
+        if( root ) { destroy( root->left );  destroy( root->right );  delete root; }
+    }
+
+    template< class Func >
+    void recursive_for_each( const_<const Node*> root, ref_<Func> consume )
+    {
+        if( root ) {
+            recursive_for_each( root->left, consume );
+            consume( root->value );
+            recursive_for_each( root->right, consume );
+        }
+    }
+
+    struct Segment{ const Node* root; bool is_single_node; };
+
+    void append_segments_of( const_<const Node*> root, const int depth, ref_<vector<Segment>> segments )
+    {
+        if( not root ) { return; }
+        if( depth == 0 ) {
+            segments.push_back( Segment{ root, false } );
+        } else {
+            append_segments_of( root->left, depth - 1, segments );
+            segments.push_back( Segment{ root, true } );
+            append_segments_of( root->right, depth - 1, segments );
+        }
+    }
+
+    // In-order segments: the subtrees at `depth` below the root, with the nodes above them.
+    auto segments_of( const_<const Node*> root, const int depth )
+        -> vector<Segment>
+    {
+        vector<Segment> result;
+        append_segments_of( root, depth, result );
+        return result;
+    }
+
+    template< class Func >
+    void for_each_in( in_<Segment> segment, ref_<Func> consume )
+    {
+        if( segment.is_single_node ) {
+            consume( segment.root->value );
+        } else {
+            recursive_for_each( segment.root, consume );
+        }
+    }
+
+    // Enough segments for some load balancing: about 4 subtrees per thread.
+    inline auto split_depth_for( const int n_threads )
+        -> int
+    {
+        int depth = 0;
+        while( (1 << depth) < 4*n_threads ) { ++depth; }
+        return depth;
+    }
+
+    // `op` must be associative and `identity` must be an identity for it.
+    template< class Value, class Op >
+    auto parallel_reduce( const_<const Node*> root, const Value identity, in_<Op> op, ref_<Thread_pool> pool )
+        -> Value
+    {
+        const vector<Segment> segments = segments_of( root, split_depth_for( pool.n_threads() ) );
+        vector<future<Value>> partial_results;
+        partial_results.reserve( segments.size() );
+        for( const Segment& segment: segments ) {
+            partial_results.push_back( pool.submit( [&segment, &identity, &op]() -> Value {
+                Value result = identity;
+                auto accumulate = [&]( const int v ) { result = op( result, v ); };
+                for_each_in( segment, accumulate );
+                return result;
+            } ) );
+        }
+        Value result = identity;
+        for( future<Value>& partial: partial_results ) { result = op( result, partial.get() ); }
+        return result;
+    }
+
+    auto values_of( const Segment segment )
+        -> Sequence_<int>
+    {
+        if( segment.is_single_node ) {
+            co_yield segment.root->value;
+            co_return;
+        }
+        auto            parents     = stack<const Node*>();
+        const Node*     current     = segment.root;
+        while( current or not is_empty( parents ) ) {
+            while( current ) {
+                parents.push( current );
+                current = current->left;
+            }
+            const_<const Node*> node = popped_top_of( parents );
+            co_yield node->value;
+            current = node->right;
+        }
+    }
+    const auto values_of_budget = Frame_budget( "segment values_of", 256, []{
+        return values_of( Segment{ nullptr, false } );
+    } );
+
+    // An ordered multi-segment sequence: concatenated they are the in-order sequence of the
+    // tree, and each can be consumed independently, e.g. in its own thread.
+    auto segment_sequences_of( const_<const Node*> root, const int depth )
+        -> vector<Sequence_<int>>
+    {
+        vector<Sequence_<int>> result;
+        for( const Segment& segment: segments_of( root, depth ) ) {
+            result.push_back( values_of( segment ) );
+        }
+        return result;
+    }
+}  // namespace bst
+
+namespace app {
+    using   cpp_machinery::const_, cpp_machinery::in_;
+    using   cpp_machinery::coroutine::Sequence_;
+    using   cpp_machinery::threading::Thread_pool;
+    using   std::future,                                    // <future>
+            std::iota,                                      // <numeric>
+            std::thread,                                    // <thread>
+            std::vector;                                    // <vector>
+    namespace chrono = std::chrono;
+
+    template< class Func >
+    auto seconds_for( in_<Func> f )
+        -> double
+    {
+        const auto start = chrono::steady_clock::now();
+        f();
+        return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+    }
+
+    void run( const int n )
+    {
+        auto values = vector<int>( n );
+        iota( values.begin(), values.end(), 1 );
+        const_<bst::Node*> root = bst::balanced_tree_of( values.data(), values.data() + n );
+        values = {};
+
+        const auto plus = []( const long long a, const long long b ) -> long long { return a + b; };
+
+        long long sum = 0;
+        const double sequential_seconds = seconds_for( [&]{
+            auto add = [&sum]( const int v ) { sum += v; };
+            bst::recursive_for_each( root, add );
+        } );
+        printf( "Summing %d values.\n", n );
+        printf( "  %-24s sum %lld, %7.3f s.\n", "Sequential:", sum, sequential_seconds );
+
+        const int n_cores = int( thread::hardware_concurrency() );
+        for( int n_threads = 1; n_threads <= (n_cores > 0? n_cores : 1); ++n_threads ) {
+            auto pool = Thread_pool( n_threads );
+            const double seconds = seconds_for( [&]{ sum = bst::parallel_reduce( root, 0LL, plus, pool ); } );
+            printf( "  %2d thread(s):%11s sum %lld, %7.3f s, speedup %.2f.\n",
+                n_threads, "", sum, seconds, sequential_seconds/seconds
+                );
+        }
+
+        // The segment sequences, consumed concurrently and checked for in-order results.
+        auto pool = Thread_pool();
+        vector<Sequence_<int>> sequences = bst::segment_sequences_of( root, bst::split_depth_for( pool.n_threads() ) );
+        vector<future<long long>> partial_sums;
+        for( Sequence_<int>& seq: sequences ) {
+            partial_sums.push_back( pool.submit( [&seq]() -> long long {
+                long long partial = 0;
+                int previous = 0;
+                for( const int v: seq ) {
+                    if( v <= previous ) { printf( "!Out of order value %d.\n", v ); }
+                    partial += v;  previous = v;
+                }
+                return partial;
+            } ) );
+        }
+        sum = 0;
+        for( future<long long>& partial: partial_sums ) { sum += partial.get(); }
+        printf( "  %-24s sum %lld, from %d sequences.\n", "Segment sequences:", sum, int( sequences.size() ) );
+
+        bst::destroy( root );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        return EXIT_SUCCESS;        // The budgets are measured at startup; the work is skipped.
+    #endif
+    const int n = (n_args > 1? atoi( args[1] ) : 10'000'000);
+    app::run( n );
+    printf( "Finished.\n" );
+}
@@ -0,0 +1,217 @@
+#include <cpp_machinery/_all.hpp>
+#include <cpp_machinery/fiber.hpp>      // Stackful fibers; POSIX only.
+
+#include <stdio.h>      // fopen, fscanf, printf
+#include <stdlib.h>     // atoi, EXIT_SUCCESS
+#include <unistd.h>     // sysconf
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <stack>
+#include <vector>
+
+// Measures the trade-off between the stackless `coroutine::Sequence_` and the stackful
+// `fiber::Fiber_sequence_`: the cost of a switch, the memory per live instance, and an
+// in-order BST traversal, which a fiber can do with plain recursion.
+
+namespace bst {
+    namespace cppm = cpp_machinery;
+    using   cppm::const_, cppm::in_, cppm::ref_, cppm::popped_top_of, cppm::is_empty;
+    using   cppm::coroutine::Frame_budget, cppm::coroutine::Sequence_;
+    using   cppm::fiber::Fiber_sequence_, cppm::fiber::Fiber_yield_;
+    using   std::stack;             // <stack>
+
+    struct Node{ int value; Node* left; Node* right; };
+
+    void insert( const int new_value, ref_<Node*> root )
+    {
+        const_<Node*> new_node = new Node{ new_value, nullptr, nullptr };
+        Node** pp = &root;
+        while( *pp ) { pp = (new_value < (*pp)->value? &(*pp)->left : &(*pp)->right); }
+        *pp = new_node;
+    }
+
+    void destroy( const_<Node*> root )
+    {
+        if( root ) { destroy( root->left );  destroy( root->right );  delete root; }
+    }
+
+    template< class Func >
+    void recursive_for_each( const_<const Node*> root, in_<Func> consume )
+    {
+        if( root ) {
+            recursive_for_each( root->left, consume );
+            consume( root->value );
+            recursive_for_each( root->right, consume );
+        }
+    }
+
+    // Stackless: the recursion must be replaced with an explicit stack.
+    auto coroutine_values_of( const_<const Node*> root )
+        -> Sequence_<int>
+    {
+        auto    parents     = stack<const Node*>();
+        auto    current     = root;
+        while( current or not is_empty( parents ) ) {
+            while( current ) {
+                parents.push( current );
+                current = current->left;
+            }
+            const_<const Node*> node = popped_top_of( parents );
+            co_yield node->value;
+            current = node->right;
+        }
+    }
+    const auto coroutine_values_of_budget = Frame_budget( "coroutine_values_of", 256, []{
+        return coroutine_values_of( nullptr );
+    } );
+
+    // Stackful: the recursive traversal as is.
+    auto fiber_values_of( const_<const Node*> root )
+        -> Fiber_sequence_<int>
+    {
+        return Fiber_sequence_<int>( [root]( const Fiber_yield_<int> yield ) { recursive_for_each( root, yield ); } );
+    }
+}  // namespace bst
+
+namespace app {
+    namespace cppm = cpp_machinery;
+    using   cppm::in_, cppm::ref_;
+    using   cppm::coroutine::Frame_budget, cppm::coroutine::Sequence_;
+    using   cppm::fiber::Fiber_sequence_, cppm::fiber::Fiber_yield_, cppm::fiber::Stack_options,
+            cppm::fiber::Stack_pool;
+    using   std::shuffle,                                   // <algorithm>
+            std::iota,                                      // <numeric>
+            std::mt19937,                                   // <random>
+            std::vector;                                    // <vector>
+    namespace chrono = std::chrono;
+
+    template< class Func >
+    auto seconds_for( in_<Func> f )
+        -> double
+    {
+        const auto start = chrono::steady_clock::now();
+        f();
+        return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+    }
+
+    auto resident_bytes()
+        -> long
+    {
+        long n_pages = 0;
+        long n_resident_pages = 0;
+        if( FILE* const f = fopen( "/proc/self/statm", "r" ) ) {
+            if( fscanf( f, "%ld %ld", &n_pages, &n_resident_pages ) != 2 ) { n_resident_pages = 0; }
+            fclose( f );
+        }
+        return n_resident_pages*sysconf( _SC_PAGESIZE );
+    }
+
+    auto coroutine_numbers( const int n )
+        -> Sequence_<int>
+    {
+        for( int i = 1; i <= n; ++i ) { co_yield i; }
+    }
+    const auto coroutine_numbers_budget = Frame_budget( "coroutine_numbers", 96, []{ return coroutine_numbers( 0 ); } );
+
+    auto fiber_numbers( const int n, ref_<Stack_pool> pool = Stack_pool::for_this_thread() )
+        -> Fiber_sequence_<int>
+    {
+        return Fiber_sequence_<int>( [n]( const Fiber_yield_<int> yield ) {
+            for( int i = 1; i <= n; ++i ) { yield( i ); }
+        }, pool );
+    }
+
+    template< class Sequence >
+    auto sum_of( Sequence&& seq )
+        -> long long
+    {
+        long long sum = 0;
+        for( const int v: seq ) { sum += v; }
+        return sum;
+    }
+
+    void report_switches( const char* const what, const int n, const long long sum, const double seconds )
+    {
+        printf( "  %-34s sum %lld, %6.2f ns per value.\n", what, sum, 1e9*seconds/n );
+    }
+
+    // Creates `n` sequences and starts them, i.e. each has produced its first value.
+    template< class Create_func >
+    void report_memory( const char* const what, const int n, in_<Create_func> create )
+    {
+        using Sequence = decltype( create() );
+        vector<Sequence> sequences;
+        sequences.reserve( n );
+        const long before = resident_bytes();
+        const double seconds = seconds_for( [&]{
+            for( int i = 0; i < n; ++i ) {
+                sequences.push_back( create() );
+                (void) sequences.back().value();
+            }
+        } );
+        const long after = resident_bytes();
+        const double destroy_seconds = seconds_for( [&]{ sequences.clear(); } );
+        printf( "  %-34s %7.0f bytes, create + start %6.0f ns, destroy %6.0f ns.\n",
+            what, double( after - before )/n, 1e9*seconds/n, 1e9*destroy_seconds/n
+            );
+    }
+
+    void run( const int n )
+    {
+        printf( "Switching, %d values:\n", n );
+        long long sum = 0;
+        double seconds = seconds_for( [&]{ sum = sum_of( coroutine_numbers( n ) ); } );
+        report_switches( "Stackless coroutine:", n, sum, seconds );
+        seconds = seconds_for( [&]{ sum = sum_of( fiber_numbers( n ) ); } );
+        report_switches( "Stackful fiber:", n, sum, seconds );
+
+        const int n_live = 100'000;
+        printf( "\nMemory per live started sequence (resident), %d sequences:\n", n_live );
+        report_memory( "Stackless coroutine:", n_live, []{ return coroutine_numbers( 1'000 ); } );
+        {
+            auto pool = Stack_pool( Stack_options{ .size = 64*1024, .has_guard_page = false, .n_stacks_per_slab = 64 } );
+            report_memory( "Fiber, 64 KB stack, no guard page:", n_live, [&]{ return fiber_numbers( 1'000, pool ); } );
+            report_memory( "Same, reusing the pooled stacks:", n_live, [&]{ return fiber_numbers( 1'000, pool ); } );
+        }
+        {
+            // With guard pages the default `vm.max_map_count` of 65530 allows about 32 K stacks.
+            const int n_guarded = 30'000;
+            auto pool = Stack_pool( Stack_options{ .size = 64*1024, .has_guard_page = true, .n_stacks_per_slab = 64 } );
+            char what[64];
+            snprintf( what, sizeof( what ), "Fiber with guard page (%d K):", n_guarded/1000 );
+            report_memory( what, n_guarded, [&]{ return fiber_numbers( 1'000, pool ); } );
+        }
+
+        auto values = vector<int>( n );
+        iota( values.begin(), values.end(), 1 );
+        shuffle( values.begin(), values.end(), mt19937( 42 ) );
+        bst::Node* root = nullptr;
+        for( const int v: values ) { bst::insert( v, root ); }
+        values = {};
+
+        printf( "\nIn-order traversal of a random BST with %d nodes:\n", n );
+        seconds = seconds_for( [&]{
+            sum = 0;
+            bst::recursive_for_each( root, [&]( const int v ) { sum += v; } );
+        } );
+        report_switches( "Recursive with callback:", n, sum, seconds );
+        seconds = seconds_for( [&]{ sum = sum_of( bst::coroutine_values_of( root ) ); } );
+        report_switches( "Coroutine with explicit stack:", n, sum, seconds );
+        seconds = seconds_for( [&]{ sum = sum_of( bst::fiber_values_of( root ) ); } );
+        report_switches( "Fiber with recursion:", n, sum, seconds );
+
+        bst::destroy( root );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        return EXIT_SUCCESS;        // The budgets are measured at startup; the work is skipped.
+    #endif
+    app::run( n_args > 1? atoi( args[1] ) : 10'000'000 );
+    printf( "Finished.\n" );
+}
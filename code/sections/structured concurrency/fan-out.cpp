@@ -0,0 +1,142 @@
+#include <cpp_machinery/_all.hpp>
+
+#include <stdio.h>      // printf
+#include <stdlib.h>     // atoi, EXIT_SUCCESS
+
+#include <chrono>
+#include <coroutine>
+#include <stop_token>
+#include <thread>
+#include <tuple>              // For structured bindings.
+#include <utility>
+#include <vector>
+
+// A controller starts N child tasks and awaits all of them, or the first of them, via
+// `when_all` and `when_any`. The children complete either in the controller's thread,
+// directly or via a run loop, or in the threads of a thread pool.
+
+namespace app {
+    namespace cppm = cpp_machinery;
+    using   cppm::in_, cppm::ref_;
+    using   cppm::coroutine::Frame_budget, cppm::coroutine::Run_loop, cppm::coroutine::Task,
+            cppm::coroutine::Task_, cppm::coroutine::when_all, cppm::coroutine::when_any;
+    using   cppm::threading::Thread_pool;
+    using   std::coroutine_handle,                          // <coroutine>
+            std::stop_source, std::stop_token,              // <stop_token>
+            std::thread,                                    // <thread>
+            std::move,                                      // <utility>
+            std::vector;                                    // <vector>
+    namespace chrono = std::chrono;
+
+    // Continues the awaiting coroutine in a thread of the pool.
+    struct Resumption_in
+    {
+        Thread_pool&    pool;
+
+        auto await_ready() const noexcept -> bool { return false; }
+        void await_suspend( const coroutine_handle<> h ) const { pool.post( [h]{ h.resume(); } ); }
+        void await_resume() const noexcept {}
+    };
+
+    auto immediate_child( const int i ) -> Task_<long long> { co_return i; }
+    const auto immediate_child_budget = Frame_budget( "immediate_child", 128, []{ return immediate_child( 0 ); } );
+
+    auto looping_child( ref_<Run_loop> loop, const int i )
+        -> Task_<long long>
+    {
+        co_await loop.next_turn();
+        co_return i;
+    }
+
+    auto pooled_child( ref_<Thread_pool> pool, const int i )
+        -> Task_<long long>
+    {
+        co_await Resumption_in{ pool };
+        long long v = 0;
+        for( int j = 0; j <= i % 100; ++j ) { v += j; }    // A little work.
+        co_return v;
+    }
+    const auto pooled_child_budget = Frame_budget( "pooled_child", 160, []{
+        static auto pool = Thread_pool( 1 );
+        return pooled_child( pool, 0 );
+    } );
+
+    // Finishes in the loop's thread, also when the last child completes in another thread.
+    auto sum_of( vector<Task_<long long>>&& children, ref_<Run_loop> loop, ref_<long long> sum )
+        -> Task
+    {
+        long long result = 0;
+        for( const long long v: co_await when_all( move( children ) ) ) { result += v; }
+        co_await loop.next_turn();
+        sum = result;
+    }
+
+    auto racer( ref_<Run_loop> loop, const int n_steps, const stop_token stop )
+        -> Task_<int>
+    {
+        int i = 0;
+        for( ; i < n_steps and not stop.stop_requested(); ++i ) { co_await loop.next_turn(); }
+        co_return i;
+    }
+
+    auto race( ref_<Run_loop> loop )
+        -> Task
+    {
+        auto stop = stop_source();
+        const auto [index, n_steps] = co_await when_any( stop,
+            racer( loop, 300, stop.get_token() ), racer( loop, 100, stop.get_token() ), racer( loop, 200, stop.get_token() )
+            );
+        printf( "  when_any: racer %d won after %d steps; the others were stopped.\n", index, n_steps );
+
+        const auto [a, b] = co_await when_all( racer( loop, 3, {} ), immediate_child( 4 ) );
+        printf( "  when_all of 2 tasks: %d and %lld.\n", a, b );
+    }
+
+    template< class Func >
+    void time( const char* const what, const int n, in_<long long> sum, in_<Func> f )
+    {
+        const auto start = chrono::steady_clock::now();
+        f();
+        const double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+        printf( "  %-34s sum %lld, %7.3f s, %6.1f ns per child.\n", what, sum, seconds, 1e9*seconds/n );
+    }
+
+    void run( const int n )
+    {
+        long long sum = 0;
+        auto loop = Run_loop();
+
+        printf( "Fan-out to %d children:\n", n );
+        time( "Completing immediately:", n, sum, [&]{
+            vector<Task_<long long>> children;
+            for( int i = 0; i < n; ++i ) { children.push_back( immediate_child( i ) ); }
+            auto controller = sum_of( move( children ), loop, sum );
+            loop.run_until( [&]{ return controller.is_done(); }, controller.handle() );
+        } );
+        time( "Completing via a run loop:", n, sum, [&]{
+            vector<Task_<long long>> children;
+            for( int i = 0; i < n; ++i ) { children.push_back( looping_child( loop, i ) ); }
+            auto controller = sum_of( move( children ), loop, sum );
+            loop.run_until( [&]{ return controller.is_done(); }, controller.handle() );
+        } );
+        const int n_threads = int( thread::hardware_concurrency() );
+        auto pool = Thread_pool( n_threads > 1? n_threads : 2 );
+        time( "Completing in a thread pool:", n, sum, [&]{
+            vector<Task_<long long>> children;
+            for( int i = 0; i < n; ++i ) { children.push_back( pooled_child( pool, i ) ); }
+            auto controller = sum_of( move( children ), loop, sum );
+            loop.run_until( [&]{ return controller.is_done(); }, controller.handle() );
+        } );
+
+        auto racing = race( loop );
+        loop.run_until( [&]{ return racing.is_done(); }, racing.handle() );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    #ifdef CPP_MACHINERY_CHECK_FRAME_BUDGETS
+        return EXIT_SUCCESS;        // The budgets are measured at startup; the work is skipped.
+    #endif
+    app::run( n_args > 1? atoi( args[1] ) : 100'000 );
+}
@@ -0,0 +1,65 @@
+#include <cpp_machinery/coroutine.hpp>
+
+#include <stdio.h>      // printf
+
+#include <chrono>
+#include <initializer_list>     // For curly braces list in range based `for`.
+
+namespace app {
+    namespace cppm = cpp_machinery;
+    using   cppm::ref_;
+    using   cppm::coroutine::Run_loop, cppm::coroutine::Task, cppm::coroutine::Task_;
+    using   namespace std::chrono_literals;
+    namespace chrono = std::chrono;
+
+    const auto start_time = chrono::steady_clock::now();
+
+    auto ms_elapsed() -> int
+    {
+        return int( chrono::duration_cast<chrono::milliseconds>( chrono::steady_clock::now() - start_time ).count() );
+    }
+
+    auto ticker( ref_<Run_loop> loop, const char* const name, const chrono::milliseconds period, const int n )
+        -> Task
+    {
+        for( int i = 1; i <= n; ++i ) {
+            co_await loop.sleep_for( period );
+            printf( "%5d ms: %s %d\n", ms_elapsed(), name, i );
+        }
+    }
+
+    auto slow_answer( ref_<Run_loop> loop, const chrono::milliseconds delay )
+        -> Task_<int>
+    {
+        co_await loop.sleep_for( delay );
+        co_return 42;
+    }
+
+    auto asker( ref_<Run_loop> loop )
+        -> Task
+    {
+        for( const auto delay: {50ms, 200ms} ) {
+            const auto answer = co_await loop.with_deadline( slow_answer( loop, delay ), 100ms );
+            if( answer ) {
+                printf( "%5d ms: answer %d after %d ms.\n", ms_elapsed(), *answer, int( delay.count() ) );
+            } else {
+                printf( "%5d ms: no answer within the 100 ms deadline.\n", ms_elapsed() );
+            }
+        }
+    }
+
+    void run()
+    {
+        auto loop = Run_loop();
+        auto fast = ticker( loop, "fast", 40ms, 5 );
+        auto slow = ticker( loop, "slow", 90ms, 2 );
+        auto questions = asker( loop );
+        loop.post( fast.handle() );
+        loop.post( slow.handle() );
+        loop.post( questions.handle() );
+        loop.run_until( [&]{ return fast.is_done() and slow.is_done() and questions.is_done(); } );
+        printf( "%5d ms: finished, %d pending timers.\n", ms_elapsed(), loop.n_pending_timers() );
+    }
+}  // namespace app
+
+auto main() -> int { app::run(); }
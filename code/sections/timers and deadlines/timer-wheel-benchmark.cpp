@@ -0,0 +1,78 @@
+#include <cpp_machinery/coroutine/Timer_wheel.hpp>
+
+#include <stdint.h>     // uint64_t
+#include <stdio.h>      // printf
+#include <stdlib.h>     // atoi
+
+#include <chrono>
+#include <memory>
+#include <random>
+
+// Schedules, cancels and fires timers in a `Timer_wheel`, without real time delays.
+
+namespace app {
+    namespace cppm = cpp_machinery;
+    using   cppm::in_, cppm::ref_;
+    using   cppm::coroutine::Timer_node, cppm::coroutine::Timer_wheel;
+    using   std::make_unique,                                   // <memory>
+            std::mt19937, std::uniform_int_distribution;        // <random>
+    namespace chrono = std::chrono;
+
+    int         n_fired             = 0;
+    uint64_t    n_fired_late        = 0;
+    Timer_wheel* p_wheel            = nullptr;
+
+    void on_expiry( ref_<Timer_node> node )
+    {
+        ++n_fired;
+        if( node.expiry_tick() != p_wheel->current_tick() ) { ++n_fired_late; }
+    }
+
+    template< class Func >
+    auto seconds_for( in_<Func> f )
+        -> double
+    {
+        const auto start = chrono::steady_clock::now();
+        f();
+        return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+    }
+
+    void report( const char* const what, const int n, const double seconds )
+    {
+        printf( "  %-34s %8.3f s, %6.1f ns per timer.\n", what, seconds, 1e9*seconds/n );
+    }
+
+    void run( const int n )
+    {
+        const auto p_nodes = make_unique<Timer_node[]>( n );
+        const auto p_wheel_storage = make_unique<Timer_wheel>();
+        ref_<Timer_wheel> wheel = *p_wheel_storage;
+        p_wheel = &wheel;
+
+        auto random_delay = uniform_int_distribution<uint64_t>( 1, 100'000 );      // Up to 100 s at 1 ms.
+        auto rng = mt19937( 42 );
+
+        printf( "%d timers, delays 1…100'000 ticks.\n", n );
+        report( "Insert:", n, seconds_for( [&]{
+            for( int i = 0; i < n; ++i ) {
+                p_nodes[i].set_on_expiry( &on_expiry );
+                wheel.insert( p_nodes[i], random_delay( rng ) );
+            }
+        } ) );
+        report( "Cancel every 2nd:", n/2, seconds_for( [&]{
+            for( int i = 0; i < n; i += 2 ) { p_nodes[i].cancel(); }
+        } ) );
+        report( "Re-insert the cancelled:", n/2, seconds_for( [&]{
+            for( int i = 0; i < n; i += 2 ) { wheel.insert( p_nodes[i], random_delay( rng ) ); }
+        } ) );
+        report( "Advance 100'000 ticks, fire all:", n, seconds_for( [&]{ wheel.advance_to( 100'000 ); } ) );
+        printf( "  %d fired, %llu not at their expiry tick, %d pending.\n",
+            n_fired, (unsigned long long) n_fired_late, wheel.n_pending()
+            );
+    }
+}  // namespace app
+
+auto main( const int n_args, char** args ) -> int
+{
+    app::run( n_args > 1? atoi( args[1] ) : 1'000'000 );
+}